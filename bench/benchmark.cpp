@@ -0,0 +1,121 @@
+#include "benchmark.hpp"
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <spdlog/spdlog.h>
+
+namespace bench {
+    namespace {
+        // nearest-rank percentile of sorted values
+        [[nodiscard]] double percentile(std::vector<double> const& sortedValues, double const fraction) noexcept {
+            auto const rank =
+                    static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sortedValues.size())));
+            return sortedValues[std::clamp(rank, std::size_t{ 1 }, sortedValues.size()) - 1];
+        }
+
+        [[nodiscard]] Summary summarize(std::vector<double> samples) {
+            std::ranges::sort(samples);
+            auto const count = static_cast<double>(samples.size());
+            auto const mean = std::accumulate(samples.cbegin(), samples.cend(), 0.0) / count;
+            auto const squaredDeviations = std::accumulate(
+                    samples.cbegin(),
+                    samples.cend(),
+                    0.0,
+                    [mean](double const sum, double const sample) { return sum + (sample - mean) * (sample - mean); }
+            );
+            return Summary{ .min{ samples.front() },
+                            .median{ percentile(samples, 0.5) },
+                            .mean{ mean },
+                            .p95{ percentile(samples, 0.95) },
+                            .max{ samples.back() },
+                            .standardDeviation{ samples.size() > 1 ? std::sqrt(squaredDeviations / (count - 1.0))
+                                                                   : 0.0 } };
+        }
+
+        // picks a unit so that the value has at most three digits before the decimal point
+        [[nodiscard]] std::string formatDuration(double const nanoseconds) {
+            if (nanoseconds < 1'000.0) {
+                return fmt::format("{:.1f} ns", nanoseconds);
+            }
+            if (nanoseconds < 1'000'000.0) {
+                return fmt::format("{:.2f} us", nanoseconds / 1'000.0);
+            }
+            return fmt::format("{:.2f} ms", nanoseconds / 1'000'000.0);
+        }
+
+        // JSON has no representation for infinity and NaN (e.g. items per second of an iteration that took no time)
+        [[nodiscard]] std::string jsonNumber(double const value) {
+            if (!std::isfinite(value)) {
+                return "null";
+            }
+            return fmt::format("{}", value);
+        }
+    } // namespace
+
+    Runner::Runner(Settings settings) noexcept : mSettings{ std::move(settings) } { }
+
+    tl::expected<void, std::string> Runner::writeJson(std::filesystem::path const& path) const {
+        auto buffer = fmt::memory_buffer{};
+        auto output = std::back_inserter(buffer);
+        fmt::format_to(output, "{{\n  \"benchmarks\": [");
+        auto separator = "";
+        for (auto const& result : mResults) {
+            auto const& summary = result.nanosecondsPerIteration;
+            fmt::format_to(
+                    output,
+                    "{}\n    {{\"name\": \"{}\", \"iterations_per_repetition\": {}, \"repetitions\": {}, "
+                    "\"items_per_iteration\": {}, \"items_per_second\": {}, \"ns_per_iteration\": {{\"min\": {}, "
+                    "\"median\": {}, \"mean\": {}, \"p95\": {}, \"max\": {}, \"standard_deviation\": {}}}}}",
+                    separator,
+                    result.name,
+                    result.iterationsPerRepetition,
+                    result.numRepetitions,
+                    result.itemsPerIteration,
+                    jsonNumber(result.itemsPerSecond()),
+                    summary.min,
+                    summary.median,
+                    summary.mean,
+                    summary.p95,
+                    summary.max,
+                    summary.standardDeviation
+            );
+            separator = ",";
+        }
+        fmt::format_to(output, "\n  ]\n}}\n");
+
+        auto file = std::ofstream{ path };
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            return tl::unexpected{ fmt::format("unable to write '{}'", path.string()) };
+        }
+        return {};
+    }
+
+    bool Runner::matchesFilter(std::string_view const name) const noexcept {
+        return mSettings.filter.empty() || name.find(mSettings.filter) != std::string_view::npos;
+    }
+
+    void Runner::addResult(
+            std::string_view const name,
+            std::uint64_t const iterationsPerRepetition,
+            std::uint64_t const itemsPerIteration,
+            std::vector<double> samples
+    ) {
+        auto const& result = mResults.emplace_back(Result{ .name{ std::string{ name } },
+                                                           .iterationsPerRepetition{ iterationsPerRepetition },
+                                                           .numRepetitions{ samples.size() },
+                                                           .itemsPerIteration{ itemsPerIteration },
+                                                           .nanosecondsPerIteration{ summarize(std::move(samples)) } });
+        auto const& summary = result.nanosecondsPerIteration;
+        spdlog::info(
+                "{:<48} median {:>10}  p95 {:>10}  min {:>10}  ±{:>5.1f}%  {:>12.4g} items/s",
+                result.name,
+                formatDuration(summary.median),
+                formatDuration(summary.p95),
+                formatDuration(summary.min),
+                summary.standardDeviation / summary.mean * 100.0,
+                result.itemsPerSecond()
+        );
+    }
+} // namespace bench
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <tl/expected.hpp>
+#include <vector>
+
+namespace bench {
+    // keeps the compiler from optimizing away the computation of value
+    template<typename T>
+    void doNotOptimize(T const& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        auto const volatile* const pointer = &value;
+        static_cast<void>(*reinterpret_cast<char const volatile*>(pointer));
+#endif
+    }
+
+    struct Settings {
+        std::chrono::nanoseconds warmupDuration{ std::chrono::milliseconds{ 200 } };
+        // the number of iterations per repetition is chosen so that every repetition takes at least this long
+        std::chrono::nanoseconds minRepetitionDuration{ std::chrono::milliseconds{ 20 } };
+        std::size_t numRepetitions{ 15 };
+        // only benchmarks whose name contains this string are run
+        std::string filter;
+    };
+
+    // all values in nanoseconds per iteration
+    struct Summary {
+        double min;
+        double median;
+        double mean;
+        double p95;
+        double max;
+        double standardDeviation;
+    };
+
+    struct Result {
+        std::string name;
+        std::uint64_t iterationsPerRepetition;
+        std::size_t numRepetitions;
+        std::uint64_t itemsPerIteration;
+        Summary nanosecondsPerIteration;
+
+        [[nodiscard]] double itemsPerSecond() const noexcept {
+            return static_cast<double>(itemsPerIteration) * 1'000'000'000.0 / nanosecondsPerIteration.median;
+        }
+    };
+
+    class Runner final {
+    public:
+        explicit Runner(Settings settings) noexcept;
+
+        // Runs function repeatedly: first for the warmup duration (which also determines the number of iterations
+        // per repetition), then for the configured number of repetitions.
+        template<std::invocable Function>
+        void run(std::string_view const name, Function&& function, std::uint64_t const itemsPerIteration = 1) {
+            if (!matchesFilter(name)) {
+                return;
+            }
+            auto numIterations = std::uint64_t{ 1 };
+            auto const warmupEndTime = Clock::now() + mSettings.warmupDuration;
+            while (true) {
+                auto const duration = measure(function, numIterations);
+                if (duration < mSettings.minRepetitionDuration) {
+                    numIterations *= 2;
+                } else if (Clock::now() >= warmupEndTime) {
+                    break;
+                }
+            }
+            auto samples = std::vector<double>{};
+            samples.reserve(mSettings.numRepetitions);
+            for (std::size_t i = 0; i < mSettings.numRepetitions; ++i) {
+                auto const duration = measure(function, numIterations);
+                auto const nanoseconds = std::chrono::duration<double, std::nano>{ duration }.count();
+                samples.push_back(nanoseconds / static_cast<double>(numIterations));
+            }
+            addResult(name, numIterations, itemsPerIteration, std::move(samples));
+        }
+
+        [[nodiscard]] std::vector<Result> const& results() const noexcept {
+            return mResults;
+        }
+        [[nodiscard]] tl::expected<void, std::string> writeJson(std::filesystem::path const& path) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        template<typename Function>
+        [[nodiscard]] static Clock::duration measure(Function& function, std::uint64_t const numIterations) {
+            auto const startTime = Clock::now();
+            for (std::uint64_t i = 0; i < numIterations; ++i) {
+                function();
+            }
+            return Clock::now() - startTime;
+        }
+
+        [[nodiscard]] bool matchesFilter(std::string_view name) const noexcept;
+        void addResult(
+                std::string_view name,
+                std::uint64_t iterationsPerRepetition,
+                std::uint64_t itemsPerIteration,
+                std::vector<double> samples
+        );
+
+    private:
+        Settings mSettings;
+        std::vector<Result> mResults;
+    };
+} // namespace bench
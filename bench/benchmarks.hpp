@@ -0,0 +1,9 @@
+#pragma once
+
+#include "benchmark.hpp"
+
+namespace bench {
+    void registerCpuBenchmarks(Runner& runner);
+    // does nothing (apart from logging) if no headless OpenGL context can be created
+    void registerGpuBenchmarks(Runner& runner);
+} // namespace bench
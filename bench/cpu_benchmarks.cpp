@@ -0,0 +1,384 @@
+#include "benchmarks.hpp"
+#include "color.hpp"
+#include "flat_hash_map.hpp"
+#include "guid.hpp"
+#include "hash/hash.hpp"
+#include "include_glm.hpp"
+#include "particle_system.hpp"
+#include "random.hpp"
+#include "rect.hpp"
+#include "render_command.hpp"
+#include "vertex_format.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace bench {
+    namespace {
+        constexpr std::size_t numCommands = 10'000;
+        constexpr std::size_t numShaders = 4;
+        constexpr std::size_t numTextures = 64;
+
+        // Same layout as RenderCommand. The real shader programs and textures can't exist without an OpenGL
+        // context, so the commands point to stand-ins that only carry the object name used as sort key.
+        struct GLObject {
+            GLuint mName;
+        };
+
+        struct Command {
+            glm::mat4 transformMatrix;
+            Rect textureRect;
+            Color color;
+            GLObject const* shader;
+            GLObject const* texture;
+        };
+
+        struct CommandSortFixture {
+            std::array<GLObject, numShaders> shaders{};
+            std::array<GLObject, numTextures> textures{};
+            std::vector<Command> unsortedCommands;
+            std::vector<Command> commands;
+
+            CommandSortFixture() {
+                for (std::size_t i = 0; i < shaders.size(); ++i) {
+                    shaders[i].mName = static_cast<GLuint>(i + 1);
+                }
+                for (std::size_t i = 0; i < textures.size(); ++i) {
+                    textures[i].mName = static_cast<GLuint>(i + 1);
+                }
+                auto random = Random{ 42 };
+                unsortedCommands.reserve(numCommands);
+                for (std::size_t i = 0; i < numCommands; ++i) {
+                    unsortedCommands.push_back(Command{
+                            .transformMatrix{ glm::mat4{ 1.0f } },
+                            .textureRect{ Rect::unit() },
+                            .color{ Color::white() },
+                            .shader{ &shaders[random.range(numShaders - 1)] },
+                            .texture{ &textures[random.range(numTextures - 1)] },
+                    });
+                }
+                commands = unsortedCommands;
+            }
+
+            void reset() {
+                std::ranges::copy(unsortedCommands, commands.begin());
+            }
+        };
+
+        [[nodiscard]] bool compareCommands(Command const& lhs, Command const& rhs) noexcept {
+            return std::tie(lhs.shader->mName, lhs.texture->mName) < std::tie(rhs.shader->mName, rhs.texture->mName);
+        }
+
+        [[nodiscard]] std::uint32_t sortKey(Command const& command) noexcept {
+            return (command.shader->mName << 16U) | command.texture->mName;
+        }
+
+        void registerSortBenchmarks(Runner& runner) {
+            auto fixture = CommandSortFixture{};
+
+            // baseline: copying the commands back is part of every sort benchmark
+            runner.run(
+                    "sort/reset",
+                    [&] {
+                        fixture.reset();
+                        doNotOptimize(fixture.commands.data());
+                    },
+                    numCommands
+            );
+
+            // what the renderer currently does
+            runner.run(
+                    "sort/std::sort",
+                    [&] {
+                        fixture.reset();
+                        std::sort(fixture.commands.begin(), fixture.commands.end(), compareCommands);
+                        doNotOptimize(fixture.commands.data());
+                    },
+                    numCommands
+            );
+
+            runner.run(
+                    "sort/std::stable_sort",
+                    [&] {
+                        fixture.reset();
+                        std::stable_sort(fixture.commands.begin(), fixture.commands.end(), compareCommands);
+                        doNotOptimize(fixture.commands.data());
+                    },
+                    numCommands
+            );
+
+            // sorts (key, index) pairs and gathers the commands afterward, so that the large commands are moved once
+            auto keys = std::vector<std::uint64_t>(numCommands);
+            auto gathered = std::vector<Command>(numCommands);
+            runner.run(
+                    "sort/key_index_sort",
+                    [&] {
+                        fixture.reset();
+                        for (std::size_t i = 0; i < fixture.commands.size(); ++i) {
+                            keys[i] = (static_cast<std::uint64_t>(sortKey(fixture.commands[i])) << 32U) | i;
+                        }
+                        std::ranges::sort(keys);
+                        for (std::size_t i = 0; i < keys.size(); ++i) {
+                            gathered[i] = fixture.commands[keys[i] & 0xFFFF'FFFFU];
+                        }
+                        doNotOptimize(gathered.data());
+                    },
+                    numCommands
+            );
+
+            // stable least significant digit radix sort over the 32 bit keys (8 bits per pass)
+            auto scratch = std::vector<std::uint64_t>(numCommands);
+            runner.run(
+                    "sort/radix_sort",
+                    [&] {
+                        fixture.reset();
+                        for (std::size_t i = 0; i < fixture.commands.size(); ++i) {
+                            keys[i] = (static_cast<std::uint64_t>(sortKey(fixture.commands[i])) << 32U) | i;
+                        }
+                        for (auto shift = 32U; shift < 64U; shift += 8U) {
+                            auto offsets = std::array<std::size_t, 256>{};
+                            for (auto const key : keys) {
+                                ++offsets[(key >> shift) & 0xFFU];
+                            }
+                            std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), std::size_t{ 0 });
+                            for (auto const key : keys) {
+                                scratch[offsets[(key >> shift) & 0xFFU]++] = key;
+                            }
+                            std::swap(keys, scratch);
+                        }
+                        for (std::size_t i = 0; i < keys.size(); ++i) {
+                            gathered[i] = fixture.commands[keys[i] & 0xFFFF'FFFFU];
+                        }
+                        doNotOptimize(gathered.data());
+                    },
+                    numCommands
+            );
+        }
+
+        template<typename Vertex>
+        void runVertexBenchmark(Runner& runner, std::string_view const name) {
+            constexpr auto numQuads = std::size_t{ 1'000 };
+            auto transforms = std::vector<glm::mat4>{};
+            transforms.reserve(numQuads);
+            auto random = Random{ 42 };
+            for (std::size_t i = 0; i < numQuads; ++i) {
+                transforms.push_back(quadTransform(
+                        glm::vec3{ random.range(-500.0f, 500.0f), random.range(-500.0f, 500.0f), 0.0f },
+                        random.range(0.0f, 2.0f * glm::pi<float>()),
+                        glm::vec2{ random.range(1.0f, 20.0f) }
+                ));
+            }
+            auto const textureRect = Rect::unit();
+            auto const color = Color{ 0.5f, 0.25f, 1.0f, 1.0f };
+            auto vertices = std::vector<Vertex>(numQuads * 4);
+            runner.run(
+                    name,
+                    [&] {
+                        for (std::size_t i = 0; i < numQuads; ++i) {
+                            writeQuadVertices(vertices.data() + i * 4, transforms[i], textureRect, color, GLuint{ 3 });
+                        }
+                        doNotOptimize(vertices.data());
+                    },
+                    numQuads
+            );
+        }
+
+        template<typename Vertex>
+        void runParticleVertexBenchmark(Runner& runner, std::string_view const name) {
+            constexpr auto numParticles = std::size_t{ 10'000 };
+            auto particleSystem = ParticleSystem{ numParticles };
+            auto random = Random{ 42 };
+            for (std::size_t i = 0; i < numParticles; ++i) {
+                static_cast<void>(particleSystem.emit(ParticleDescription{
+                        .position{ random.range(-500.0f, 500.0f), random.range(-500.0f, 500.0f) },
+                        .velocity{ random.range(-10.0f, 10.0f), random.range(-10.0f, 10.0f) },
+                        .lifetime{ random.range(1.0f, 5.0f) },
+                        .size{ random.range(1.0f, 4.0f) },
+                        .color{ 1.0f, 0.5f, 0.0f, 1.0f },
+                }));
+            }
+            auto vertices = std::vector<Vertex>(particleSystem.size() * 4);
+            runner.run(
+                    name,
+                    [&] {
+                        particleSystem.writeQuadVertices(vertices.data(), 0, particleSystem.size(), GLuint{ 1 });
+                        doNotOptimize(vertices.data());
+                    },
+                    particleSystem.size()
+            );
+        }
+
+        void registerVertexBenchmarks(Runner& runner) {
+            runVertexBenchmark<StandardVertex>(runner, "vertices/quads/standard");
+            runVertexBenchmark<CompactVertex>(runner, "vertices/quads/compact");
+            runVertexBenchmark<CompactHalfPositionVertex>(runner, "vertices/quads/compact_half_position");
+            runParticleVertexBenchmark<StandardVertex>(runner, "vertices/particles/standard");
+            runParticleVertexBenchmark<CompactVertex>(runner, "vertices/particles/compact");
+            runParticleVertexBenchmark<CompactHalfPositionVertex>(runner, "vertices/particles/compact_half_position");
+        }
+
+        void registerHashBenchmarks(Runner& runner) {
+            for (auto const length : { std::size_t{ 8 }, std::size_t{ 32 }, std::size_t{ 256 } }) {
+                auto const string = std::string(length, 'x');
+                runner.run(
+                        fmt::format("hash/hash_string/{}", length),
+                        [&] {
+                            doNotOptimize(hash::hashString(string));
+                        },
+                        length
+                );
+            }
+        }
+
+        // The keys are hash values, like the uniform name hashes of ShaderProgram.
+        template<typename Map>
+        void runMapBenchmarks(Runner& runner, std::string_view const name, std::size_t const numElements) {
+            auto random = Random{ 42 };
+            auto keys = std::vector<std::uint64_t>(numElements);
+            auto missingKeys = std::vector<std::uint64_t>(numElements);
+            random.fill(keys);
+            random.fill(missingKeys);
+
+            auto map = Map{};
+            for (auto const key : keys) {
+                map[key] = key;
+            }
+
+            runner.run(
+                    fmt::format("map/{}/{}/find_hit", name, numElements),
+                    [&] {
+                        auto sum = std::uint64_t{ 0 };
+                        for (auto const key : keys) {
+                            sum += map.find(key)->second;
+                        }
+                        doNotOptimize(sum);
+                    },
+                    numElements
+            );
+
+            runner.run(
+                    fmt::format("map/{}/{}/find_miss", name, numElements),
+                    [&] {
+                        auto numFound = std::size_t{ 0 };
+                        for (auto const key : missingKeys) {
+                            if (map.find(key) != map.end()) {
+                                ++numFound;
+                            }
+                        }
+                        doNotOptimize(numFound);
+                    },
+                    numElements
+            );
+
+            runner.run(
+                    fmt::format("map/{}/{}/insert", name, numElements),
+                    [&] {
+                        auto newMap = Map{};
+                        for (auto const key : keys) {
+                            newMap.try_emplace(key, key);
+                        }
+                        doNotOptimize(newMap.size());
+                    },
+                    numElements
+            );
+        }
+
+        void registerMapBenchmarks(Runner& runner) {
+            for (auto const numElements : { std::size_t{ 16 }, std::size_t{ 1'024 }, std::size_t{ 65'536 } }) {
+                runMapBenchmarks<FlatHashMap<std::uint64_t, std::uint64_t>>(runner, "flat_hash_map", numElements);
+                runMapBenchmarks<std::unordered_map<std::uint64_t, std::uint64_t>>(
+                        runner,
+                        "std::unordered_map",
+                        numElements
+                );
+                runMapBenchmarks<std::map<std::uint64_t, std::uint64_t>>(runner, "std::map", numElements);
+            }
+        }
+
+        void registerRandomBenchmarks(Runner& runner) {
+            constexpr auto numValues = std::size_t{ 4'096 };
+            auto random = Random{ 42 };
+            auto floats = std::vector<float>(numValues);
+            auto integers = std::vector<std::uint32_t>(numValues);
+
+            runner.run(
+                    "random/get<float>",
+                    [&] {
+                        for (auto& value : floats) {
+                            value = random.get<float>();
+                        }
+                        doNotOptimize(floats.data());
+                    },
+                    numValues
+            );
+
+            runner.run(
+                    "random/range<int>",
+                    [&] {
+                        for (auto& value : integers) {
+                            value = random.range(std::uint32_t{ 1'000 });
+                        }
+                        doNotOptimize(integers.data());
+                    },
+                    numValues
+            );
+
+            runner.run(
+                    "random/fill<float>",
+                    [&] {
+                        random.fill(floats);
+                        doNotOptimize(floats.data());
+                    },
+                    numValues
+            );
+
+            runner.run(
+                    "random/fill<uint32_t, range>",
+                    [&] {
+                        random.fill(integers, 0U, 1'000U);
+                        doNotOptimize(integers.data());
+                    },
+                    numValues
+            );
+
+            // reference point for the engine
+            auto mersenneTwister = std::mt19937_64{ 42 };
+            auto distribution = std::uniform_real_distribution<float>{ 0.0f, 1.0f };
+            runner.run(
+                    "random/std::mt19937_64",
+                    [&] {
+                        for (auto& value : floats) {
+                            value = distribution(mersenneTwister);
+                        }
+                        doNotOptimize(floats.data());
+                    },
+                    numValues
+            );
+        }
+
+        void registerGuidBenchmarks(Runner& runner) {
+            runner.run("guid/create", [] { doNotOptimize(GUID::create()); });
+            auto const guid = GUID::create();
+            runner.run("guid/string", [&] { doNotOptimize(guid.string()); });
+            auto const string = guid.string();
+            runner.run("guid/from_string", [&] { doNotOptimize(GUID::fromString(string)); });
+            runner.run("guid/hash", [&] { doNotOptimize(std::hash<GUID>{}(guid)); });
+        }
+    } // namespace
+
+    void registerCpuBenchmarks(Runner& runner) {
+        registerSortBenchmarks(runner);
+        registerVertexBenchmarks(runner);
+        registerHashBenchmarks(runner);
+        registerMapBenchmarks(runner);
+        registerRandomBenchmarks(runner);
+        registerGuidBenchmarks(runner);
+    }
+} // namespace bench
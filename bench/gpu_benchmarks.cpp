@@ -0,0 +1,114 @@
+#include "benchmarks.hpp"
+#include "canvas_kernel.hpp"
+#include "input.hpp"
+#include "launch_options.hpp"
+#include "opengl_version.hpp"
+#include "texture.hpp"
+#include "window.hpp"
+#include <GLFW/glfw3.h>
+#include <array>
+#include <glad/gl.h>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace bench {
+    namespace {
+        constexpr auto openGLVersion = OpenGLVersion{ .major{ 4 }, .minor{ 5 } };
+
+        // Window terminates the program if no context can be created, so the availability is checked up front
+        // (with the same hints that Window uses in headless mode).
+        [[nodiscard]] bool isHeadlessContextAvailable() noexcept {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            if (glfwInit() == GLFW_FALSE) {
+                return false;
+            }
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, openGLVersion.major);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, openGLVersion.minor);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            auto isAvailable = false;
+            for (auto const contextCreationApi : { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API }) {
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextCreationApi);
+                if (auto const window = glfwCreateWindow(16, 16, "probe", nullptr, nullptr); window != nullptr) {
+                    glfwDestroyWindow(window);
+                    isAvailable = true;
+                    break;
+                }
+            }
+            glfwTerminate();
+            return isAvailable;
+        }
+
+        void registerCanvasKernelBenchmarks(Runner& runner) {
+            constexpr auto resolutions = std::array{
+                glm::ivec2{   100,   75 },
+                glm::ivec2{   400,  300 },
+                glm::ivec2{ 1'600, 1'200 },
+            };
+            for (auto const backend : { CanvasBackend::Cpu, CanvasBackend::Compute }) {
+                auto const backendName = backend == CanvasBackend::Cpu ? "cpu" : "compute";
+                for (auto const resolution : resolutions) {
+                    auto kernel = createDiffusionKernel(backend, resolution);
+                    if (!kernel) {
+                        spdlog::warn("unable to create the {} diffusion kernel: {}", backendName, kernel.error());
+                        continue;
+                    }
+                    auto const numPixels =
+                            static_cast<std::uint64_t>(resolution.x) * static_cast<std::uint64_t>(resolution.y);
+                    auto const suffix = fmt::format("{}/{}x{}", backendName, resolution.x, resolution.y);
+                    // glFinish() makes sure the GPU work is part of the measurement
+                    runner.run(
+                            fmt::format("canvas_kernel/diffusion_step/{}", suffix),
+                            [&] {
+                                (*kernel)->step(1.0f / 60.0f);
+                                glFinish();
+                            },
+                            numPixels
+                    );
+                    runner.run(
+                            fmt::format("canvas_kernel/read_back/{}", suffix),
+                            [&] {
+                                doNotOptimize((*kernel)->readBack().data());
+                            },
+                            numPixels
+                    );
+                }
+            }
+        }
+
+        void registerTextureUploadBenchmarks(Runner& runner) {
+            for (auto const size : { 256, 1'024, 2'048 }) {
+                auto texture = Texture::createForStorage(size, size);
+                if (!texture) {
+                    spdlog::warn("unable to create the texture: {}", texture.error());
+                    continue;
+                }
+                auto const numBytes = static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4;
+                auto const pixels = std::vector<unsigned char>(numBytes, 0x7F);
+                runner.run(
+                        fmt::format("texture/upload/{}x{}", size, size),
+                        [&] {
+                            texture->setData(pixels);
+                            glFinish();
+                        },
+                        numBytes
+                );
+            }
+        }
+    } // namespace
+
+    void registerGpuBenchmarks(Runner& runner) {
+        if (!isHeadlessContextAvailable()) {
+            spdlog::warn("no headless OpenGL context available, skipping the GPU benchmarks");
+            return;
+        }
+        auto input = Input{};
+        auto window = Window{ "c2k_pixelator_bench",
+                              WindowSize{ .width{ 64 }, .height{ 64 } },
+                              openGLVersion,
+                              input,
+                              WindowMode::Headless };
+        registerCanvasKernelBenchmarks(runner);
+        registerTextureUploadBenchmarks(runner);
+    }
+} // namespace bench
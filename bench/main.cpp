@@ -0,0 +1,76 @@
+#include "benchmarks.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <string_view>
+
+namespace {
+    void printUsage() {
+        spdlog::info(
+                "usage: c2k_pixelator_bench [--filter <substring>] [--json <file>] [--repetitions <n>] "
+                "[--warmup-ms <ms>] [--min-time-ms <ms>] [--no-gpu]"
+        );
+    }
+
+    template<typename T>
+    [[nodiscard]] std::optional<T> parseNumber(std::string_view const text) noexcept {
+        auto result = T{};
+        auto const [end, errorCode] = std::from_chars(text.data(), text.data() + text.size(), result);
+        if (errorCode != std::errc{} || end != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return result;
+    }
+} // namespace
+
+int main(int const argc, char const* const* const argv) {
+    auto settings = bench::Settings{};
+    auto jsonPath = std::optional<std::string_view>{};
+    auto runGpuBenchmarks = true;
+
+    for (auto i = 1; i < argc; ++i) {
+        auto const argument = std::string_view{ argv[i] };
+        if (argument == "--no-gpu") {
+            runGpuBenchmarks = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        auto const value = std::string_view{ argv[++i] };
+        if (argument == "--filter") {
+            settings.filter = value;
+        } else if (argument == "--json") {
+            jsonPath = value;
+        } else if (auto const number = parseNumber<std::size_t>(value); !number) {
+            spdlog::error("invalid value '{}' for {}", value, argument);
+            return EXIT_FAILURE;
+        } else if (argument == "--repetitions" && *number > 0) {
+            settings.numRepetitions = *number;
+        } else if (argument == "--warmup-ms") {
+            settings.warmupDuration = std::chrono::milliseconds{ *number };
+        } else if (argument == "--min-time-ms") {
+            settings.minRepetitionDuration = std::chrono::milliseconds{ *number };
+        } else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto runner = bench::Runner{ settings };
+    bench::registerCpuBenchmarks(runner);
+    if (runGpuBenchmarks) {
+        bench::registerGpuBenchmarks(runner);
+    }
+
+    if (jsonPath) {
+        if (auto const result = runner.writeJson(*jsonPath); !result) {
+            spdlog::error("{}", result.error());
+            return EXIT_FAILURE;
+        }
+        spdlog::info("results written to '{}'", *jsonPath);
+    }
+    return EXIT_SUCCESS;
+}
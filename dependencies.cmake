@@ -20,7 +20,7 @@ function(setup_dependencies)
     CPMAddPackage(
             NAME GLFW
             GITHUB_REPOSITORY glfw/glfw
-            GIT_TAG 3.3.9
+            GIT_TAG 3.4
             OPTIONS
             "GLFW_BUILD_DOCS OFF"
             "GLFW_INSTALL OFF"
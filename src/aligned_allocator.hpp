@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// std::allocator replacement that aligns every allocation (e.g. to cache lines for SIMD friendly arrays)
+template<typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template<typename U>
+    AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept { }
+
+    [[nodiscard]] T* allocate(std::size_t const count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ Alignment }));
+    }
+
+    void deallocate(T* const pointer, std::size_t const count) noexcept {
+        ::operator delete(pointer, count * sizeof(T), std::align_val_t{ Alignment });
+    }
+
+    template<typename U>
+    [[nodiscard]] bool operator==(AlignedAllocator<U, Alignment> const&) const noexcept {
+        return true;
+    }
+};
+
+template<typename T, std::size_t Alignment = 64>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
@@ -0,0 +1,206 @@
+#include "allocation_tracker.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <spdlog/spdlog.h>
+
+namespace {
+    // Plain counters with constant initialization: operator new can be called before any dynamic initialization
+    // and while threads are exiting, so the counters must not have constructors or destructors.
+    constinit thread_local AllocationCounts tThreadCounts{};
+    constinit std::atomic_uint64_t sTotalNumAllocations{ 0ULL };
+    constinit std::atomic_uint64_t sTotalNumAllocatedBytes{ 0ULL };
+    constinit std::atomic_uint64_t sTotalNumDeallocations{ 0ULL };
+
+#if ENABLE_ALLOCATION_TRACKING
+    void countAllocation(std::size_t const size) noexcept {
+        ++tThreadCounts.numAllocations;
+        tThreadCounts.numAllocatedBytes += size;
+        sTotalNumAllocations.fetch_add(1, std::memory_order_relaxed);
+        sTotalNumAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void countDeallocation() noexcept {
+        ++tThreadCounts.numDeallocations;
+        sTotalNumDeallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] void* tryAllocate(std::size_t const size, std::size_t const alignment) noexcept {
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return std::malloc(size);
+        }
+#ifdef _MSC_VER
+        return _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    void release(void* const pointer, std::size_t const alignment) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        countDeallocation();
+#ifdef _MSC_VER
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            _aligned_free(pointer);
+            return;
+        }
+#else
+        static_cast<void>(alignment);
+#endif
+        std::free(pointer);
+    }
+
+    // follows the semantics of the standard operator new: retry via the new handler, throw if there is none
+    [[nodiscard]] void* allocate(std::size_t size, std::size_t const alignment) {
+        if (size == 0) {
+            size = 1;
+        }
+        while (true) {
+            if (auto const pointer = tryAllocate(size, alignment); pointer != nullptr) {
+                countAllocation(size);
+                return pointer;
+            }
+            auto const newHandler = std::get_new_handler();
+            if (newHandler == nullptr) {
+                throw std::bad_alloc{};
+            }
+            newHandler();
+        }
+    }
+
+    [[nodiscard]] void* allocate(std::size_t const size, std::size_t const alignment, std::nothrow_t const&) noexcept {
+        try {
+            return allocate(size, alignment);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    constexpr auto defaultAlignment = std::size_t{ __STDCPP_DEFAULT_NEW_ALIGNMENT__ };
+#endif
+} // namespace
+
+std::optional<AllocationPolicy> parseAllocationPolicy(std::string_view const text) noexcept {
+    if (text == "ignore") {
+        return AllocationPolicy::Ignore;
+    }
+    if (text == "warn") {
+        return AllocationPolicy::Warn;
+    }
+    if (text == "assert") {
+        return AllocationPolicy::Assert;
+    }
+    return std::nullopt;
+}
+
+AllocationCounts AllocationTracker::threadCounts() noexcept {
+    return tThreadCounts;
+}
+
+AllocationCounts AllocationTracker::totalCounts() noexcept {
+    return AllocationCounts{ .numAllocations{ sTotalNumAllocations.load(std::memory_order_relaxed) },
+                             .numAllocatedBytes{ sTotalNumAllocatedBytes.load(std::memory_order_relaxed) },
+                             .numDeallocations{ sTotalNumDeallocations.load(std::memory_order_relaxed) } };
+}
+
+void AllocationTracker::check(
+        AllocationCounts const& counts,
+        AllocationPolicy const policy,
+        std::string_view const what
+) noexcept {
+    if (policy == AllocationPolicy::Ignore || counts.numAllocations == 0) {
+        return;
+    }
+    if (policy == AllocationPolicy::Warn) {
+        spdlog::warn("{} allocated {} times ({} bytes)", what, counts.numAllocations, counts.numAllocatedBytes);
+        return;
+    }
+    spdlog::critical("{} allocated {} times ({} bytes)", what, counts.numAllocations, counts.numAllocatedBytes);
+    std::terminate();
+}
+
+#if ENABLE_ALLOCATION_TRACKING
+void* operator new(std::size_t const size) {
+    return allocate(size, defaultAlignment);
+}
+
+void* operator new[](std::size_t const size) {
+    return allocate(size, defaultAlignment);
+}
+
+void* operator new(std::size_t const size, std::align_val_t const alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t const size, std::align_val_t const alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t const size, std::nothrow_t const& tag) noexcept {
+    return allocate(size, defaultAlignment, tag);
+}
+
+void* operator new[](std::size_t const size, std::nothrow_t const& tag) noexcept {
+    return allocate(size, defaultAlignment, tag);
+}
+
+void* operator new(std::size_t const size, std::align_val_t const alignment, std::nothrow_t const& tag) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment), tag);
+}
+
+void* operator new[](std::size_t const size, std::align_val_t const alignment, std::nothrow_t const& tag) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment), tag);
+}
+
+void operator delete(void* const pointer) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* const pointer) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* const pointer, std::size_t) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* const pointer, std::align_val_t const alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const pointer, std::align_val_t const alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* const pointer, std::size_t, std::align_val_t const alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const pointer, std::size_t, std::align_val_t const alignment) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* const pointer, std::nothrow_t const&) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete[](void* const pointer, std::nothrow_t const&) noexcept {
+    release(pointer, defaultAlignment);
+}
+
+void operator delete(void* const pointer, std::align_val_t const alignment, std::nothrow_t const&) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* const pointer, std::align_val_t const alignment, std::nothrow_t const&) noexcept {
+    release(pointer, static_cast<std::size_t>(alignment));
+}
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+// Has to be defined for the whole build (e.g. via target_compile_definitions), because it replaces the global
+// operator new and delete.
+#ifndef ENABLE_ALLOCATION_TRACKING
+#define ENABLE_ALLOCATION_TRACKING 0
+#endif
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+struct AllocationCounts {
+    std::uint64_t numAllocations{ 0ULL };
+    std::uint64_t numAllocatedBytes{ 0ULL };
+    std::uint64_t numDeallocations{ 0ULL };
+
+    [[nodiscard]] AllocationCounts operator-(AllocationCounts const& other) const noexcept {
+        return AllocationCounts{ .numAllocations{ numAllocations - other.numAllocations },
+                                 .numAllocatedBytes{ numAllocatedBytes - other.numAllocatedBytes },
+                                 .numDeallocations{ numDeallocations - other.numDeallocations } };
+    }
+};
+
+enum class AllocationPolicy {
+    Ignore,
+    Warn,
+    // logs and terminates, also in release builds
+    Assert,
+};
+
+[[nodiscard]] std::optional<AllocationPolicy> parseAllocationPolicy(std::string_view text) noexcept;
+
+// Counts the heap allocations made through the global operator new. The counters are thread-local, so reading
+// them is cheap and the allocations of a scope (a frame, a profiler zone) are the difference of two reads on the
+// same thread. Without ENABLE_ALLOCATION_TRACKING all counts are zero.
+class AllocationTracker final {
+public:
+    AllocationTracker() = delete;
+
+    [[nodiscard]] static constexpr bool isEnabled() noexcept {
+        return ENABLE_ALLOCATION_TRACKING != 0;
+    }
+    // allocations of the calling thread since it started
+    [[nodiscard]] static AllocationCounts threadCounts() noexcept;
+    // allocations of all threads since the program started
+    [[nodiscard]] static AllocationCounts totalCounts() noexcept;
+
+    // applies the policy if counts contain any allocations, what describes the scope in the log message
+    static void check(AllocationCounts const& counts, AllocationPolicy policy, std::string_view what) noexcept;
+
+    // measures the allocations of the calling thread between construction and counts()
+    class Scope final {
+    public:
+        Scope() noexcept : mStartCounts{ threadCounts() } { }
+
+        [[nodiscard]] AllocationCounts counts() const noexcept {
+            return threadCounts() - mStartCounts;
+        }
+
+    private:
+        AllocationCounts mStartCounts;
+    };
+};
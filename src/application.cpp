@@ -1,10 +1,17 @@
 #include "application.hpp"
+#include "frame_arena.hpp"
+#include "gl_state_cache.hpp"
+#include "gpu_timer.hpp"
+#include "trace_capture.hpp"
 #include <algorithm>
+#include <cassert>
 #include <chrono>
 #include <cmath>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <iterator>
+#include <memory_resource>
 #include <spdlog/spdlog.h>
 #include <variant>
 
@@ -45,13 +52,64 @@ namespace {
 
 } // namespace
 
-Application::Application(std::string const& title, WindowSize size, OpenGLVersion version) noexcept
-    : mWindow{ title, size, version, mInput },
+Application::Application(
+        std::string const& title,
+        WindowSize size,
+        OpenGLVersion version,
+        LaunchOptions const& launchOptions
+) noexcept
+    : mLaunchOptions{ launchOptions },
+      mSteadyStateAllocationPolicy{ launchOptions.steadyStateAllocationPolicy },
+      mFirstSteadyStateFrame{ launchOptions.firstSteadyStateFrame },
+      mWindow{ title, size, version, mInput, launchOptions.windowMode },
       mRenderer{ mWindow },
-      mAppContext{ mTime, mInput, *this } { }
+      mAppContext{ mTime, mInput, *this } {
+    if (launchOptions.simulationStepsPerFrame) {
+        setFixedTimestep(FixedTimestepSettings{ .stepsPerFrame{ launchOptions.simulationStepsPerFrame } });
+    }
+    if (launchOptions.framePacing) {
+        setFramePacing(*launchOptions.framePacing);
+    }
+    if (launchOptions.useRenderThread) {
+        enableRenderThread();
+    }
+    if (launchOptions.traceFrames) {
+        TraceCapture::captureFrameRange(*launchOptions.traceFrames);
+    }
+    if (launchOptions.replayInputFile) {
+        if (auto recording = InputRecording::load(*launchOptions.replayInputFile)) {
+            spdlog::info(
+                    "replaying {} frames from {}",
+                    recording->numFrames(),
+                    launchOptions.replayInputFile->string()
+            );
+            mRandom.seed(recording->randomSeed());
+            mInputReplay.emplace(std::move(*recording), launchOptions.replayDelta);
+            mInput.mIsReplaying = true;
+        } else {
+            spdlog::error("unable to replay input: {}", recording.error());
+        }
+    } else if (launchOptions.recordInputFile) {
+        // the seed is part of the recording so that the replay draws the same random numbers
+        auto const randomSeed = mRandom.get<std::uint64_t>();
+        mRandom.seed(randomSeed);
+        mInputRecording.emplace(randomSeed);
+        // the state from before the recording started
+        mInputRecording->record(InputEvent::mouseEnterOrLeave(mInput.mouseInsideWindow()));
+        mInputRecording->record(InputEvent::mouseMove(mInput.mousePosition().x, mInput.mousePosition().y));
+        mInput.mRecording = &*mInputRecording;
+    }
+}
 
 Application::~Application() noexcept {
+    if (TraceCapture::isCapturing()) {
+        if (auto const result = TraceCapture::stop(); !result) {
+            spdlog::error("trace capture failed: {}", result.error());
+        }
+    }
     ScopedTimer::logResults();
+    GpuTimer::logResults();
+    GpuTimer::releaseQueries();
 }
 
 void Application::run() noexcept {
@@ -60,27 +118,219 @@ void Application::run() noexcept {
 #else
     spdlog::info("This is the release build");
 #endif
+    ScopedTimer::setThreadName("main thread");
     setup();
-    auto timeMeasurements = setupTimeMeasurements();
-    while (!glfwWindowShouldClose(mWindow.getGLFWWindowPointer())) {
+    if (mUseRenderThread) {
+        // creates the device objects of the ImGui backend while the context is still current on this thread
         ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-        renderImGui();
-        ImGui::Render();
-
-        update();
-
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        mRenderThread = std::make_unique<RenderThread>(mWindow, mRenderer);
+    }
+    auto timeMeasurements = setupTimeMeasurements();
+    while (!mWindow.shouldClose() && !mLaunchOptions.isFinished(mNumFramesRendered, mTime.elapsed)
+           && !(mInputReplay && mInputReplay->isFinished())) {
+        auto const frameAllocations = AllocationTracker::Scope{};
+        TraceCapture::nextFrame(mNumFramesRendered);
+        mFrameStatistics.beginFrame();
+        if (mRenderThread) {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Wait);
+            mCurrentFrame = &mRenderThread->beginFrame();
+        }
+        if (mInput.keyPressed(Key::F3)) {
+            mIsFrameStatisticsOverlayVisible = !mIsFrameStatisticsOverlayVisible;
+        }
+        if (mInput.keyPressed(Key::F4)) {
+            TraceCapture::toggle();
+        }
+        {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::ImGui);
+            if (!mRenderThread) {
+                ImGui_ImplOpenGL3_NewFrame();
+            }
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+            renderImGui();
+            if (mIsFrameStatisticsOverlayVisible) {
+                mFrameStatistics.renderOverlay(&mIsFrameStatisticsOverlayVisible);
+            }
+            ImGui::Render();
+        }
+        {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Simulation);
+            runSimulationSteps();
+        }
+        auto const numEndedFramesBeforeUpdate = mRenderer.numEndedFrames();
+        {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Update);
+            update();
+        }
 
-        glfwSwapBuffers(mWindow.getGLFWWindowPointer());
+        if (mRenderThread) {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Present);
+            mCurrentFrame->time = mTime;
+            mCurrentFrame->imGuiDrawData.capture(*ImGui::GetDrawData());
+            mRenderThread->submitFrame();
+            mCurrentFrame = nullptr;
+        } else {
+            // endFrame() is called from within update(), but not necessarily in every frame
+            if (mRenderer.numEndedFrames() != numEndedFramesBeforeUpdate) {
+                auto const flushDuration = mRenderer.stats().flushDuration;
+                mFrameStatistics.addPhaseDuration(FramePhase::Flush, flushDuration);
+                mFrameStatistics.addPhaseDuration(FramePhase::Update, -flushDuration);
+            }
+            {
+                auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::ImGui);
+                GPU_SCOPED_TIMER_NAMED("ImGui");
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            }
+            {
+                auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Present);
+                mWindow.swapBuffers();
+            }
+            GLStateCache::instance().nextFrame();
+            GpuTimer::nextFrame();
+        }
+        ++mNumFramesRendered;
         mInput.nextFrame();
-        glfwPollEvents();
+        {
+            auto const phaseTimer = mFrameStatistics.measurePhase(FramePhase::Wait);
+            mFramePacer.waitForNextFrame();
+        }
+        mFrameStatistics.endFrame(GpuTimer::lastFrameDuration());
         makeTimeMeasurementsStep(timeMeasurements, mTime);
+        recordOrReplayInput();
         refreshWindowTitle();
+        checkFrameAllocations(frameAllocations.counts());
+        FrameArena::threadLocal().reset();
+    }
+    // waits for the frames in flight and hands the context back to this thread
+    mRenderThread.reset();
+    if (mSimulationScheduler.numSteps() > 0) {
+        spdlog::info(
+                "simulation: {} steps ({:.0f} steps/s), {:.3f} s of simulation time dropped",
+                mSimulationScheduler.numSteps(),
+                static_cast<double>(mSimulationScheduler.numSteps()) / mSimulationDuration,
+                mSimulationScheduler.droppedTime()
+        );
+    }
+    spdlog::info("frame arena high-water mark: {} bytes", FrameArena::threadLocal().highWaterMark());
+    if (mNumAllocatingSteadyStateFrames > 0) {
+        spdlog::warn(
+                "{} of {} steady state frames allocated",
+                mNumAllocatingSteadyStateFrames,
+                mNumFramesRendered - std::min(mFirstSteadyStateFrame, mNumFramesRendered)
+        );
+    }
+    if (mInputRecording) {
+        mInput.mRecording = nullptr;
+        if (auto const result = mInputRecording->save(*mLaunchOptions.recordInputFile); result) {
+            spdlog::info(
+                    "recorded {} frames to {}",
+                    mInputRecording->numFrames(),
+                    mLaunchOptions.recordInputFile->string()
+            );
+        } else {
+            spdlog::error("{}", result.error());
+        }
+    }
+    if (mWindow.mode() == WindowMode::Headless) {
+        spdlog::info(
+                "headless run finished after {} frames ({:.2f} s, {:.2f} fps)",
+                mNumFramesRendered,
+                mTime.elapsed,
+                mTime.meanFramesPerSecond
+        );
+    }
+}
+
+void Application::runSimulationSteps() noexcept {
+    auto const numSteps = mSimulationScheduler.advance(mTime.delta);
+    auto const startTime = std::chrono::high_resolution_clock::now();
+    for (std::uint32_t i = 0; i < numSteps; ++i) {
+        fixedUpdate();
+        mTime.simulationElapsed += mTime.fixedDelta;
+    }
+    mSimulationDuration += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    mTime.interpolationAlpha = mSimulationScheduler.interpolationAlpha();
+}
+
+void Application::recordOrReplayInput() noexcept {
+    if (mInputRecording) {
+        mInputRecording->commitFrame(mTime.delta);
+        return;
+    }
+    if (!mInputReplay || mInputReplay->isFinished()) {
+        return;
+    }
+    auto const frame = mInputReplay->nextFrame();
+    mTime.elapsed += frame.delta - mTime.delta;
+    mTime.delta = frame.delta;
+    // the recording has no timestamps, so the events are spread evenly over the replayed frame
+    auto const frameEndTime = glfwGetTime();
+    auto const timeStep = frame.delta / static_cast<double>(std::max(frame.events.size(), std::size_t{ 1 }));
+    for (std::size_t i = 0; i < frame.events.size(); ++i) {
+        mInput.apply(frame.events[i], frameEndTime - static_cast<double>(frame.events.size() - i - 1) * timeStep);
     }
 }
 
+void Application::checkFrameAllocations(AllocationCounts const& allocations) noexcept {
+    mLastFrameAllocations = allocations;
+    if constexpr (!AllocationTracker::isEnabled()) {
+        return;
+    }
+    TraceCapture::counter("allocations", static_cast<double>(allocations.numAllocations));
+    TraceCapture::counter("allocated bytes", static_cast<double>(allocations.numAllocatedBytes));
+    // the frame counter has already been incremented
+    auto const isSteadyState = mNumFramesRendered > mFirstSteadyStateFrame;
+    if (!isSteadyState || mSteadyStateAllocationPolicy == AllocationPolicy::Ignore || allocations.numAllocations == 0) {
+        return;
+    }
+    ++mNumAllocatingSteadyStateFrames;
+    // only the first violation is logged, the others are summarized at the end of the run
+    if (mNumAllocatingSteadyStateFrames == 1 || mSteadyStateAllocationPolicy == AllocationPolicy::Assert) {
+        AllocationTracker::check(
+                allocations,
+                mSteadyStateAllocationPolicy,
+                fmt::format("steady state frame {}", mNumFramesRendered - 1)
+        );
+    }
+}
+
+void Application::expectAllocationFreeFrames(AllocationPolicy const policy) noexcept {
+    mSteadyStateAllocationPolicy = policy;
+    mFirstSteadyStateFrame = mNumFramesRendered;
+}
+
+void Application::setFixedTimestep(FixedTimestepSettings const& settings) noexcept {
+    mSimulationScheduler.setSettings(settings);
+    mTime.fixedDelta = settings.stepDuration;
+}
+
+FrameStatistics const& Application::frameStatistics() const noexcept {
+    return mFrameStatistics;
+}
+
+AllocationCounts const& Application::lastFrameAllocations() const noexcept {
+    return mLastFrameAllocations;
+}
+
+void Application::setFramePacing(FramePacingSettings const& settings) noexcept {
+    mFramePacer.setSettings(settings);
+}
+
+void Application::requestRedraw() noexcept {
+    mFramePacer.requestRedraw();
+}
+
+void Application::enableRenderThread() noexcept {
+    assert(mRenderThread == nullptr && "the render thread has to be enabled before run()");
+    mUseRenderThread = true;
+}
+
+FramePacket& Application::currentFrame() noexcept {
+    assert(mCurrentFrame != nullptr && "there is no frame being recorded");
+    return *mCurrentFrame;
+}
+
 void Application::quit() noexcept {
     glfwSetWindowShouldClose(mWindow.getGLFWWindowPointer(), true);
 }
@@ -88,9 +338,14 @@ void Application::quit() noexcept {
 
 void Application::refreshWindowTitle() noexcept {
     static std::string titleText = "";
-    auto const targetTitleText =
-            fmt::format("{:.2f} ms ({:.2f} fps)", mTime.meanFrameTime() * 1000.0, mTime.meanFramesPerSecond);
-    if (titleText != targetTitleText) {
+    auto targetTitleText = std::pmr::string{ FrameArena::threadLocal().resource() };
+    fmt::format_to(
+            std::back_inserter(targetTitleText),
+            "{:.2f} ms ({:.2f} fps)",
+            mTime.meanFrameTime() * 1000.0,
+            mTime.meanFramesPerSecond
+    );
+    if (titleText != std::string_view{ targetTitleText }) {
         glfwSetWindowTitle(mWindow.getGLFWWindowPointer(), targetTitleText.c_str());
         titleText = targetTitleText;
     }
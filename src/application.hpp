@@ -4,22 +4,31 @@
 
 #pragma once
 
+#include "allocation_tracker.hpp"
 #include "application_context.hpp"
+#include "fixed_timestep_scheduler.hpp"
+#include "frame_pacer.hpp"
+#include "frame_statistics.hpp"
 #include "input.hpp"
+#include "input_recording.hpp"
+#include "launch_options.hpp"
 #include "opengl_version.hpp"
 #include "random.hpp"
+#include "render_thread.hpp"
 #include "renderer.hpp"
 #include "scoped_timer.hpp"
 #include "time.hpp"
 #include "window.hpp"
 #include "window_size.hpp"
+#include <memory>
 
 class Application {
 public:
     explicit Application(
             std::string const& title = "c2k application",
             WindowSize size = WindowSize{ .width{ 800 }, .height{ 600 } },
-            OpenGLVersion version = OpenGLVersion{ .major{ 4 }, .minor{ 5 } }
+            OpenGLVersion version = OpenGLVersion{ .major{ 4 }, .minor{ 5 } },
+            LaunchOptions const& launchOptions = LaunchOptions::fromEnvironment()
     ) noexcept;
     Application(Application const&) = delete;
     Application(Application&&) = delete;
@@ -28,13 +37,43 @@ public:
     Application& operator=(Application&&) = delete;
     void run() noexcept;
     void quit() noexcept;
+    // renders a new frame in on-demand pacing mode; can be called from any thread
+    void requestRedraw() noexcept;
+    // timings of the most recent frames, the overlay can be toggled with F3 (F4 starts and stops a trace capture)
+    [[nodiscard]] FrameStatistics const& frameStatistics() const noexcept;
+    // heap allocations of the main thread during the last frame (see AllocationTracker)
+    [[nodiscard]] AllocationCounts const& lastFrameAllocations() const noexcept;
 
 private:
     virtual void setup() noexcept = 0;
+    // called zero or more times per frame (before update()), each call advances the simulation by mTime.fixedDelta
+    virtual void fixedUpdate() noexcept { }
     virtual void update() noexcept = 0;
+    void runSimulationSteps() noexcept;
+    // commits the input of the frame to the recording or replaces it (and the frame delta) with the replayed one
+    void recordOrReplayInput() noexcept;
+    void checkFrameAllocations(AllocationCounts const& allocations) noexcept;
     virtual void renderImGui() noexcept { }
     void refreshWindowTitle() noexcept;
 
+private:
+    LaunchOptions mLaunchOptions;
+    std::uint64_t mNumFramesRendered{ 0ULL };
+    FixedTimestepScheduler mSimulationScheduler;
+    FramePacer mFramePacer;
+    FrameStatistics mFrameStatistics;
+    bool mIsFrameStatisticsOverlayVisible{ false };
+    double mSimulationDuration{ 0.0 };
+    bool mUseRenderThread{ false };
+    std::unique_ptr<RenderThread> mRenderThread;
+    FramePacket* mCurrentFrame{ nullptr };
+    std::optional<InputRecording> mInputRecording;
+    std::optional<InputReplay> mInputReplay;
+    AllocationCounts mLastFrameAllocations;
+    AllocationPolicy mSteadyStateAllocationPolicy{ AllocationPolicy::Ignore };
+    std::uint64_t mFirstSteadyStateFrame{ 0ULL };
+    std::uint64_t mNumAllocatingSteadyStateFrames{ 0ULL };
+
 protected:
     Input mInput;
     Window mWindow;
@@ -42,4 +81,21 @@ protected:
     Time mTime;
     Random mRandom;
     ApplicationContext mAppContext;
+
+protected:
+    void setFixedTimestep(FixedTimestepSettings const& settings) noexcept;
+    // has to be called before run() when the render thread is enabled
+    void setFramePacing(FramePacingSettings const& settings) noexcept;
+    // Has to be called before run(). setup() still runs on the calling thread, afterwards the OpenGL context
+    // belongs to the render thread: update() must not call OpenGL (or mRenderer) directly but record into
+    // currentFrame() instead.
+    void enableRenderThread() noexcept;
+    [[nodiscard]] bool usesRenderThread() const noexcept {
+        return mUseRenderThread;
+    }
+    // the frame that is recorded by update() when the render thread is enabled
+    [[nodiscard]] FramePacket& currentFrame() noexcept;
+    // Frames from the current one on are expected to not allocate on the main thread, violations are handled
+    // according to the policy. Only has an effect with ENABLE_ALLOCATION_TRACKING.
+    void expectAllocationFreeFrames(AllocationPolicy policy) noexcept;
 };
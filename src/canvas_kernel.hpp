@@ -0,0 +1,39 @@
+#pragma once
+
+#include "color.hpp"
+#include "include_glm.hpp"
+#include "texture.hpp"
+#include <memory>
+#include <string>
+#include <tl/expected.hpp>
+#include <vector>
+
+enum class CanvasBackend {
+    Cpu,
+    Compute,
+};
+
+// A simulation step that operates on an RGBA8 canvas. The backends produce comparable results, but the compute
+// backend keeps the state on the GPU and only transfers it when readBack() is called.
+class CanvasKernel {
+public:
+    CanvasKernel() = default;
+    CanvasKernel(CanvasKernel const&) = delete;
+    CanvasKernel(CanvasKernel&&) = delete;
+    CanvasKernel& operator=(CanvasKernel const&) = delete;
+    CanvasKernel& operator=(CanvasKernel&&) = delete;
+    virtual ~CanvasKernel() = default;
+
+    // positions outside of the canvas are ignored
+    virtual void setPixel(glm::ivec2 position, Color const& color) noexcept = 0;
+    virtual void step(float deltaTime) noexcept = 0;
+    // texture with the current state, ready to be drawn
+    [[nodiscard]] virtual Texture const& texture() noexcept = 0;
+    // tightly packed RGBA8 pixels, row by row starting at the bottom
+    [[nodiscard]] virtual std::vector<unsigned char> readBack() noexcept = 0;
+    [[nodiscard]] virtual glm::ivec2 resolution() const noexcept = 0;
+};
+
+// blurs the canvas over time, borders are cleared
+[[nodiscard]] tl::expected<std::unique_ptr<CanvasKernel>, std::string>
+createDiffusionKernel(CanvasBackend backend, glm::ivec2 resolution) noexcept;
@@ -0,0 +1,237 @@
+#include "canvas_kernel.hpp"
+#include "scoped_timer.hpp"
+#include "shader_program.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gsl/gsl>
+#include <utility>
+
+namespace {
+    constexpr auto diffusionRate = 0.2f;
+
+    // interpolation factor between a pixel and the average of its neighborhood
+    [[nodiscard]] float blendFactor(float const deltaTime) noexcept {
+        return 1.0f - std::pow(1.0f - diffusionRate, deltaTime);
+    }
+
+    [[nodiscard]] bool isInside(glm::ivec2 const position, glm::ivec2 const resolution) noexcept {
+        return position.x >= 0 && position.y >= 0 && position.x < resolution.x && position.y < resolution.y;
+    }
+
+    class CpuDiffusionKernel final : public CanvasKernel {
+    public:
+        CpuDiffusionKernel(glm::ivec2 const resolution, Texture texture)
+            : mResolution{ resolution },
+              mPixels(static_cast<std::size_t>(resolution.x * resolution.y) * 4U, 0),
+              mNextPixels(mPixels.size(), 0),
+              mTexture{ std::move(texture) } { }
+
+        void setPixel(glm::ivec2 const position, Color const& color) noexcept override {
+            if (!isInside(position, mResolution)) {
+                return;
+            }
+            auto const index = pixelIndex(position);
+            mPixels[index + 0] = static_cast<unsigned char>(color.r * 255.0f);
+            mPixels[index + 1] = static_cast<unsigned char>(color.g * 255.0f);
+            mPixels[index + 2] = static_cast<unsigned char>(color.b * 255.0f);
+            mPixels[index + 3] = static_cast<unsigned char>(color.a * 255.0f);
+            mIsTextureOutdated = true;
+        }
+
+        void step(float const deltaTime) noexcept override {
+            SCOPED_TIMER_NAMED("CPU diffusion");
+            auto const factor = blendFactor(deltaTime);
+            std::fill(mNextPixels.begin(), mNextPixels.end(), static_cast<unsigned char>(0));
+            for (auto y = 1; y < mResolution.y - 1; ++y) {
+                for (auto x = 1; x < mResolution.x - 1; ++x) {
+                    auto sum = glm::vec4{ 0.0f };
+                    for (auto v = y - 1; v <= y + 1; ++v) {
+                        for (auto u = x - 1; u <= x + 1; ++u) {
+                            sum += pixel(glm::ivec2{ u, v });
+                        }
+                    }
+                    auto const lerped = glm::mix(pixel(glm::ivec2{ x, y }), sum / 9.0f, factor);
+                    auto const index = pixelIndex(glm::ivec2{ x, y });
+                    mNextPixels[index + 0] = static_cast<unsigned char>(lerped.r * 255.0f);
+                    mNextPixels[index + 1] = static_cast<unsigned char>(lerped.g * 255.0f);
+                    mNextPixels[index + 2] = static_cast<unsigned char>(lerped.b * 255.0f);
+                    mNextPixels[index + 3] = static_cast<unsigned char>(lerped.a * 255.0f);
+                }
+            }
+            std::swap(mPixels, mNextPixels);
+            mIsTextureOutdated = true;
+        }
+
+        [[nodiscard]] Texture const& texture() noexcept override {
+            if (mIsTextureOutdated) {
+                mTexture.setData(mPixels);
+                mIsTextureOutdated = false;
+            }
+            return mTexture;
+        }
+
+        [[nodiscard]] std::vector<unsigned char> readBack() noexcept override {
+            return mPixels;
+        }
+
+        [[nodiscard]] glm::ivec2 resolution() const noexcept override {
+            return mResolution;
+        }
+
+    private:
+        [[nodiscard]] std::size_t pixelIndex(glm::ivec2 const position) const noexcept {
+            return static_cast<std::size_t>(position.x + position.y * mResolution.x) * 4U;
+        }
+
+        [[nodiscard]] glm::vec4 pixel(glm::ivec2 const position) const noexcept {
+            auto const index = pixelIndex(position);
+            return glm::vec4{ static_cast<float>(mPixels[index + 0]),
+                              static_cast<float>(mPixels[index + 1]),
+                              static_cast<float>(mPixels[index + 2]),
+                              static_cast<float>(mPixels[index + 3]) }
+                   / 255.0f;
+        }
+
+    private:
+        glm::ivec2 mResolution;
+        std::vector<unsigned char> mPixels;
+        std::vector<unsigned char> mNextPixels;
+        Texture mTexture;
+        bool mIsTextureOutdated{ true };
+    };
+
+    constexpr auto computeWorkGroupSize = 8;
+
+    constexpr auto diffusionComputeShaderSource = R"(#version 450 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0, rgba8) uniform readonly image2D uSource;
+layout (binding = 1, rgba8) uniform writeonly image2D uDestination;
+
+uniform float uBlendFactor;
+
+void main() {
+    ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(uSource);
+    if (position.x >= size.x || position.y >= size.y) {
+        return;
+    }
+    if (position.x == 0 || position.y == 0 || position.x == size.x - 1 || position.y == size.y - 1) {
+        imageStore(uDestination, position, vec4(0.0));
+        return;
+    }
+    vec4 sum = vec4(0.0);
+    for (int v = -1; v <= 1; ++v) {
+        for (int u = -1; u <= 1; ++u) {
+            sum += imageLoad(uSource, position + ivec2(u, v));
+        }
+    }
+    vec4 lerped = mix(imageLoad(uSource, position), sum / 9.0, uBlendFactor);
+    // truncate like the CPU backend does, storing to rgba8 would round otherwise
+    imageStore(uDestination, position, floor(lerped * 255.0) / 255.0);
+})";
+
+    class ComputeDiffusionKernel final : public CanvasKernel {
+    public:
+        ComputeDiffusionKernel(
+                glm::ivec2 const resolution,
+                ShaderProgram program,
+                UniformHandle<float> const blendFactorUniform,
+                Texture front,
+                Texture back
+        )
+            : mResolution{ resolution },
+              mProgram{ std::move(program) },
+              mBlendFactorUniform{ blendFactorUniform },
+              mTextures{ std::move(front), std::move(back) } {
+            auto const clearColor = std::array<unsigned char, 4>{ 0, 0, 0, 0 };
+            for (auto const& texture : mTextures) {
+                texture.fillRegion(0, 0, resolution.x, resolution.y, clearColor);
+            }
+        }
+
+        void setPixel(glm::ivec2 const position, Color const& color) noexcept override {
+            if (!isInside(position, mResolution)) {
+                return;
+            }
+            auto const pixel = std::array{ static_cast<unsigned char>(color.r * 255.0f),
+                                           static_cast<unsigned char>(color.g * 255.0f),
+                                           static_cast<unsigned char>(color.b * 255.0f),
+                                           static_cast<unsigned char>(color.a * 255.0f) };
+            mTextures[mCurrent].fillRegion(position.x, position.y, 1, 1, pixel);
+        }
+
+        void step(float const deltaTime) noexcept override {
+            SCOPED_TIMER_NAMED("compute diffusion");
+            auto const next = 1U - mCurrent;
+            mProgram.bind();
+            mProgram.setUniform(mBlendFactorUniform, blendFactor(deltaTime));
+            mTextures[mCurrent].bindImage(0U, GL_READ_ONLY);
+            mTextures[next].bindImage(1U, GL_WRITE_ONLY);
+            glDispatchCompute(
+                    static_cast<GLuint>((mResolution.x + computeWorkGroupSize - 1) / computeWorkGroupSize),
+                    static_cast<GLuint>((mResolution.y + computeWorkGroupSize - 1) / computeWorkGroupSize),
+                    1U
+            );
+            // the result is read by the next dispatch, by sampling and by texture downloads
+            glMemoryBarrier(
+                    GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT
+            );
+            mCurrent = next;
+        }
+
+        [[nodiscard]] Texture const& texture() noexcept override {
+            return mTextures[mCurrent];
+        }
+
+        [[nodiscard]] std::vector<unsigned char> readBack() noexcept override {
+            auto result = std::vector<unsigned char>(static_cast<std::size_t>(mResolution.x * mResolution.y) * 4U);
+            mTextures[mCurrent].readData(result);
+            return result;
+        }
+
+        [[nodiscard]] glm::ivec2 resolution() const noexcept override {
+            return mResolution;
+        }
+
+    private:
+        glm::ivec2 mResolution;
+        ShaderProgram mProgram;
+        UniformHandle<float> mBlendFactorUniform;
+        std::array<Texture, 2> mTextures;
+        std::size_t mCurrent{ 0 };
+    };
+} // namespace
+
+tl::expected<std::unique_ptr<CanvasKernel>, std::string>
+createDiffusionKernel(CanvasBackend const backend, glm::ivec2 const resolution) noexcept {
+    auto front = Texture::createForStorage(resolution.x, resolution.y);
+    if (!front) {
+        return tl::unexpected{ front.error() };
+    }
+    if (backend == CanvasBackend::Cpu) {
+        return std::make_unique<CpuDiffusionKernel>(resolution, std::move(front.value()));
+    }
+
+    auto back = Texture::createForStorage(resolution.x, resolution.y);
+    if (!back) {
+        return tl::unexpected{ back.error() };
+    }
+    auto program = ShaderProgram{};
+    if (!program.compileCompute(diffusionComputeShaderSource)) {
+        return tl::unexpected{ std::string{ "Failed to compile the diffusion compute shader." } };
+    }
+    auto const blendFactorUniform = program.uniformHandle<float>("uBlendFactor");
+    if (!blendFactorUniform) {
+        return tl::unexpected{ blendFactorUniform.error() };
+    }
+    return std::make_unique<ComputeDiffusionKernel>(
+            resolution,
+            std::move(program),
+            blendFactorUniform.value(),
+            std::move(front.value()),
+            std::move(back.value())
+    );
+}
@@ -0,0 +1,37 @@
+#include "fixed_timestep_scheduler.hpp"
+#include <cassert>
+#include <cmath>
+
+FixedTimestepScheduler::FixedTimestepScheduler(FixedTimestepSettings const& settings) noexcept {
+    setSettings(settings);
+}
+
+std::uint32_t FixedTimestepScheduler::advance(double const frameDuration) noexcept {
+    if (mSettings.stepsPerFrame) {
+        // the rendered state always is the result of the last step
+        mInterpolationAlpha = 0.0;
+        mNumSteps += *mSettings.stepsPerFrame;
+        return *mSettings.stepsPerFrame;
+    }
+
+    mAccumulator += frameDuration;
+    auto numSteps = std::floor(mAccumulator / mSettings.stepDuration);
+    if (numSteps > static_cast<double>(mSettings.maxStepsPerFrame)) {
+        auto const numDroppedSteps = numSteps - static_cast<double>(mSettings.maxStepsPerFrame);
+        mDroppedTime += numDroppedSteps * mSettings.stepDuration;
+        mAccumulator -= numDroppedSteps * mSettings.stepDuration;
+        numSteps = static_cast<double>(mSettings.maxStepsPerFrame);
+    }
+    mAccumulator -= numSteps * mSettings.stepDuration;
+    mInterpolationAlpha = mAccumulator / mSettings.stepDuration;
+    auto const result = static_cast<std::uint32_t>(numSteps);
+    mNumSteps += result;
+    return result;
+}
+
+void FixedTimestepScheduler::setSettings(FixedTimestepSettings const& settings) noexcept {
+    assert(settings.stepDuration > 0.0);
+    mSettings = settings;
+    mAccumulator = 0.0;
+    mInterpolationAlpha = 0.0;
+}
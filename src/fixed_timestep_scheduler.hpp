@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+struct FixedTimestepSettings {
+    double stepDuration{ 1.0 / 120.0 };
+    // caps the catch-up after long frames so that an expensive simulation can't spiral; time beyond the cap is dropped
+    std::uint32_t maxStepsPerFrame{ 8 };
+    // batch mode: runs exactly this many steps per rendered frame, regardless of the elapsed time
+    std::optional<std::uint32_t> stepsPerFrame;
+};
+
+// Accumulates frame time and converts it into a number of fixed-length simulation steps.
+class FixedTimestepScheduler final {
+public:
+    explicit FixedTimestepScheduler(FixedTimestepSettings const& settings = FixedTimestepSettings{}) noexcept;
+
+    // returns the number of simulation steps to run for a frame that took frameDuration seconds
+    [[nodiscard]] std::uint32_t advance(double frameDuration) noexcept;
+    // how far (in [0, 1)) the current time is between the last and the next simulation step
+    [[nodiscard]] double interpolationAlpha() const noexcept {
+        return mInterpolationAlpha;
+    }
+    [[nodiscard]] FixedTimestepSettings const& settings() const noexcept {
+        return mSettings;
+    }
+    void setSettings(FixedTimestepSettings const& settings) noexcept;
+    [[nodiscard]] std::uint64_t numSteps() const noexcept {
+        return mNumSteps;
+    }
+    [[nodiscard]] double droppedTime() const noexcept {
+        return mDroppedTime;
+    }
+
+private:
+    FixedTimestepSettings mSettings;
+    double mAccumulator{ 0.0 };
+    double mInterpolationAlpha{ 0.0 };
+    double mDroppedTime{ 0.0 };
+    std::uint64_t mNumSteps{ 0ULL };
+};
@@ -0,0 +1,491 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace detail {
+    // A control byte per slot: 0b0hhhhhhh for a full slot (h = 7 bits of the hash), the negative values mark free
+    // slots. Deleted slots (tombstones) keep probe sequences intact until the next rehash.
+    inline constexpr std::int8_t emptyControl = -128; // 0b10000000
+    inline constexpr std::int8_t deletedControl = -2; // 0b11111110
+    inline constexpr std::size_t controlGroupWidth = 8;
+
+    // control bytes of a map without slots, so that lookups don't need a special case
+    alignas(controlGroupWidth) inline std::int8_t emptyControlGroup[controlGroupWidth]{
+        emptyControl, emptyControl, emptyControl, emptyControl,
+        emptyControl, emptyControl, emptyControl, emptyControl,
+    };
+
+    // Matches the control bytes of eight consecutive slots at once by treating them as a 64 bit integer (SWAR).
+    // The results are masks with the highest bit of every matching byte set.
+    class ControlGroup final {
+        static_assert(std::endian::native == std::endian::little);
+
+    public:
+        explicit ControlGroup(std::int8_t const* const control) noexcept {
+            std::memcpy(&mBits, control, sizeof(mBits));
+        }
+
+        // can have false positives for full slots next to a real match, keys have to be compared anyway
+        [[nodiscard]] std::uint64_t match(std::uint8_t const hash) const noexcept {
+            auto const bits = mBits ^ (lowBits * hash);
+            return (bits - lowBits) & ~bits & highBits;
+        }
+        [[nodiscard]] std::uint64_t matchEmpty() const noexcept {
+            return mBits & ~(mBits << 6U) & highBits;
+        }
+        [[nodiscard]] std::uint64_t matchEmptyOrDeleted() const noexcept {
+            return mBits & ~(mBits << 7U) & highBits;
+        }
+        [[nodiscard]] static std::size_t lowestIndex(std::uint64_t const mask) noexcept {
+            return static_cast<std::size_t>(std::countr_zero(mask)) / 8;
+        }
+
+    private:
+        static constexpr std::uint64_t lowBits = 0x0101'0101'0101'0101ULL;
+        static constexpr std::uint64_t highBits = 0x8080'8080'8080'8080ULL;
+
+        std::uint64_t mBits;
+    };
+
+    // Folded 128 bit product with a large odd constant: every input bit affects all output bits, so identity
+    // hashes (integers, std::hash of integers) and keys that already are hash values work well.
+    [[nodiscard]] inline std::uint64_t mixHash(std::uint64_t const hash) noexcept {
+        constexpr auto multiplier = std::uint64_t{ 0x9E37'79B9'7F4A'7C15ULL };
+#if defined(__SIZEOF_INT128__)
+        auto const product = __extension__ static_cast<unsigned __int128>(hash) * multiplier;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64U);
+#else
+        auto high = std::uint64_t{};
+        auto const low = _umul128(hash, multiplier, &high);
+        return low ^ high;
+#endif
+    }
+} // namespace detail
+
+// Open addressing hash map in the style of SwissTable: keys and values are stored inline in one array, a
+// separate array of control bytes is probed eight slots at a time. Compared to std::unordered_map, lookups
+// touch far less memory and inserting doesn't allocate per element.
+// Unlike std::unordered_map, references and iterators are invalidated by every insertion that grows the map,
+// and the keys must not be modified through the iterators.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap final {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+    template<bool IsConst>
+    class Iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, value_type const*, value_type*>;
+        using reference = std::conditional_t<IsConst, value_type const&, value_type&>;
+
+        Iterator() noexcept = default;
+        // iterator to const_iterator (a template, so that it doesn't replace the copy constructor)
+        template<bool OtherIsConst>
+            requires(IsConst && !OtherIsConst)
+        Iterator(Iterator<OtherIsConst> const& other) noexcept
+            : mControl{ other.mControl },
+              mSlot{ other.mSlot },
+              mEnd{ other.mEnd } { }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return *mSlot;
+        }
+        [[nodiscard]] pointer operator->() const noexcept {
+            return mSlot;
+        }
+        Iterator& operator++() noexcept {
+            ++mControl;
+            ++mSlot;
+            skipFreeSlots();
+            return *this;
+        }
+        Iterator operator++(int) noexcept {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        [[nodiscard]] bool operator==(Iterator const& other) const noexcept {
+            return mControl == other.mControl;
+        }
+
+    private:
+        Iterator(std::int8_t const* const control, pointer const slot, std::int8_t const* const end) noexcept
+            : mControl{ control },
+              mSlot{ slot },
+              mEnd{ end } {
+            skipFreeSlots();
+        }
+
+        void skipFreeSlots() noexcept {
+            while (mControl != mEnd && *mControl < 0) {
+                ++mControl;
+                ++mSlot;
+            }
+        }
+
+    private:
+        std::int8_t const* mControl{ nullptr };
+        pointer mSlot{ nullptr };
+        std::int8_t const* mEnd{ nullptr };
+
+        friend class FlatHashMap;
+        friend class Iterator<true>;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    FlatHashMap() noexcept = default;
+
+    FlatHashMap(FlatHashMap const& other) : mHash{ other.mHash }, mEqual{ other.mEqual } {
+        reserve(other.size());
+        for (auto const& [key, value] : other) {
+            static_cast<void>(try_emplace(key, value));
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : mControl{ std::exchange(other.mControl, detail::emptyControlGroup) },
+          mSlots{ std::exchange(other.mSlots, nullptr) },
+          mMask{ std::exchange(other.mMask, 0) },
+          mSize{ std::exchange(other.mSize, 0) },
+          mGrowthLeft{ std::exchange(other.mGrowthLeft, 0) },
+          mHash{ std::move(other.mHash) },
+          mEqual{ std::move(other.mEqual) } { }
+
+    FlatHashMap& operator=(FlatHashMap const& other) {
+        if (this != &other) {
+            auto copy = other;
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        auto moved = FlatHashMap{ std::move(other) };
+        swap(moved);
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        destroySlots();
+        deallocate();
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator{ mControl, mSlots, mControl + capacity() };
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator{ mControl + capacity(), mSlots + capacity(), mControl + capacity() };
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator{ mControl, mSlots, mControl + capacity() };
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator{ mControl + capacity(), mSlots + capacity(), mControl + capacity() };
+    }
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    [[nodiscard]] const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return mSize;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return mSize == 0;
+    }
+    // number of slots, at most 7/8 of them are used before the map grows
+    [[nodiscard]] size_type capacity() const noexcept {
+        return mSlots == nullptr ? 0 : mMask + 1;
+    }
+
+    [[nodiscard]] iterator find(Key const& key) {
+        auto const index = findIndex(key, mixedHash(key));
+        return index == notFound ? end() : iteratorAt(index);
+    }
+    [[nodiscard]] const_iterator find(Key const& key) const {
+        auto const index = findIndex(key, mixedHash(key));
+        return index == notFound ? end() : const_iterator{ iteratorAt(index) };
+    }
+    [[nodiscard]] bool contains(Key const& key) const {
+        return findIndex(key, mixedHash(key)) != notFound;
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key const& key, Args&&... args) {
+        return emplaceImpl(key, std::forward<Args>(args)...);
+    }
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return emplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(Key const& key, V&& value) {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    Value& operator[](Key const& key) {
+        return try_emplace(key).first->second;
+    }
+    Value& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // returns the number of removed elements (0 or 1)
+    size_type erase(Key const& key) {
+        auto const index = findIndex(key, mixedHash(key));
+        if (index == notFound) {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+    void erase(const_iterator const position) {
+        eraseAt(static_cast<std::size_t>(position.mControl - mControl));
+    }
+
+    // keeps the allocated memory
+    void clear() noexcept {
+        destroySlots();
+        if (mSlots != nullptr) {
+            std::memset(mControl, detail::emptyControl, capacity() + detail::controlGroupWidth);
+        }
+        mSize = 0;
+        mGrowthLeft = maxLoad(capacity());
+    }
+
+    void reserve(size_type const numElements) {
+        if (numElements > mSize + mGrowthLeft) {
+            resize(capacityFor(numElements));
+        }
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        using std::swap;
+        swap(mControl, other.mControl);
+        swap(mSlots, other.mSlots);
+        swap(mMask, other.mMask);
+        swap(mSize, other.mSize);
+        swap(mGrowthLeft, other.mGrowthLeft);
+        swap(mHash, other.mHash);
+        swap(mEqual, other.mEqual);
+    }
+    friend void swap(FlatHashMap& lhs, FlatHashMap& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+private:
+    static constexpr auto notFound = ~std::size_t{ 0 };
+    static constexpr std::size_t minCapacity = detail::controlGroupWidth;
+
+    // visits the groups starting at the position given by the hash with growing (triangular) steps, which visits
+    // every group once when the capacity is a power of two
+    class ProbeSequence final {
+    public:
+        ProbeSequence(std::uint64_t const hash, std::size_t const mask) noexcept
+            : mOffset{ (hash >> 7U) & mask },
+              mMask{ mask } { }
+
+        [[nodiscard]] std::size_t offset() const noexcept {
+            return mOffset;
+        }
+        [[nodiscard]] std::size_t offset(std::size_t const indexInGroup) const noexcept {
+            return (mOffset + indexInGroup) & mMask;
+        }
+        void next() noexcept {
+            mStep += detail::controlGroupWidth;
+            mOffset = (mOffset + mStep) & mMask;
+        }
+
+    private:
+        std::size_t mOffset;
+        std::size_t mMask;
+        std::size_t mStep{ 0 };
+    };
+
+private:
+    [[nodiscard]] static std::size_t maxLoad(std::size_t const capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+    [[nodiscard]] static std::size_t capacityFor(std::size_t const numElements) noexcept {
+        return std::max(std::bit_ceil(numElements + (numElements + 6) / 7), minCapacity);
+    }
+    [[nodiscard]] static std::uint8_t controlHash(std::uint64_t const hash) noexcept {
+        return static_cast<std::uint8_t>(hash & 0x7FU);
+    }
+
+    [[nodiscard]] std::uint64_t mixedHash(Key const& key) const {
+        return detail::mixHash(mHash(key));
+    }
+
+    [[nodiscard]] iterator iteratorAt(std::size_t const index) const noexcept {
+        auto result = iterator{};
+        result.mControl = mControl + index;
+        result.mSlot = mSlots + index;
+        result.mEnd = mControl + capacity();
+        return result;
+    }
+
+    [[nodiscard]] std::size_t findIndex(Key const& key, std::uint64_t const hash) const {
+        auto probe = ProbeSequence{ hash, mMask };
+        while (true) {
+            auto const group = detail::ControlGroup{ mControl + probe.offset() };
+            for (auto matches = group.match(controlHash(hash)); matches != 0; matches &= matches - 1) {
+                auto const index = probe.offset(detail::ControlGroup::lowestIndex(matches));
+                if (mEqual(mSlots[index].first, key)) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty() != 0) {
+                return notFound;
+            }
+            probe.next();
+        }
+    }
+
+    // the map must have at least one free slot
+    [[nodiscard]] std::size_t findFreeIndex(std::uint64_t const hash) const noexcept {
+        auto probe = ProbeSequence{ hash, mMask };
+        while (true) {
+            auto const group = detail::ControlGroup{ mControl + probe.offset() };
+            if (auto const matches = group.matchEmptyOrDeleted(); matches != 0) {
+                return probe.offset(detail::ControlGroup::lowestIndex(matches));
+            }
+            probe.next();
+        }
+    }
+
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> emplaceImpl(K&& key, Args&&... args) {
+        auto const hash = mixedHash(key);
+        if (auto const index = findIndex(key, hash); index != notFound) {
+            return { iteratorAt(index), false };
+        }
+        auto index = findFreeIndex(hash);
+        // reusing a tombstone doesn't reduce the number of empty slots
+        if (mGrowthLeft == 0 && mControl[index] != detail::deletedControl) {
+            growForInsertion();
+            index = findFreeIndex(hash);
+        }
+        if (mControl[index] == detail::emptyControl) {
+            --mGrowthLeft;
+        }
+        std::construct_at(
+                mSlots + index,
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...)
+        );
+        setControl(index, static_cast<std::int8_t>(controlHash(hash)));
+        ++mSize;
+        return { iteratorAt(index), true };
+    }
+
+    void growForInsertion() {
+        if (capacity() == 0) {
+            resize(minCapacity);
+        } else if (mSize <= maxLoad(capacity()) / 2) {
+            // mostly tombstones: rehashing in place is enough
+            resize(capacity());
+        } else {
+            resize(capacity() * 2);
+        }
+    }
+
+    void eraseAt(std::size_t const index) {
+        std::destroy_at(mSlots + index);
+        setControl(index, detail::deletedControl);
+        --mSize;
+    }
+
+    void setControl(std::size_t const index, std::int8_t const value) noexcept {
+        mControl[index] = value;
+        // the control bytes of the first group are mirrored behind the last slot, so that groups can be loaded at
+        // every position without wrapping around
+        if (index < detail::controlGroupWidth) {
+            mControl[capacity() + index] = value;
+        }
+    }
+
+    void resize(std::size_t const newCapacity) {
+        auto const oldControl = mControl;
+        auto const oldSlots = mSlots;
+        auto const oldCapacity = capacity();
+
+        mControl = new std::int8_t[newCapacity + detail::controlGroupWidth];
+        std::memset(mControl, detail::emptyControl, newCapacity + detail::controlGroupWidth);
+        mSlots = std::allocator<value_type>{}.allocate(newCapacity);
+        mMask = newCapacity - 1;
+        mGrowthLeft = maxLoad(newCapacity) - mSize;
+
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldControl[i] < 0) {
+                continue;
+            }
+            auto const hash = mixedHash(oldSlots[i].first);
+            auto const index = findFreeIndex(hash);
+            std::construct_at(mSlots + index, std::move(oldSlots[i]));
+            std::destroy_at(oldSlots + i);
+            setControl(index, static_cast<std::int8_t>(controlHash(hash)));
+        }
+        if (oldSlots != nullptr) {
+            std::allocator<value_type>{}.deallocate(oldSlots, oldCapacity);
+            delete[] oldControl;
+        }
+    }
+
+    void destroySlots() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (std::size_t i = 0; i < capacity(); ++i) {
+                if (mControl[i] >= 0) {
+                    std::destroy_at(mSlots + i);
+                }
+            }
+        }
+    }
+
+    void deallocate() noexcept {
+        if (mSlots != nullptr) {
+            std::allocator<value_type>{}.deallocate(mSlots, capacity());
+            delete[] mControl;
+        }
+    }
+
+private:
+    std::int8_t* mControl{ detail::emptyControlGroup };
+    value_type* mSlots{ nullptr };
+    std::size_t mMask{ 0 };
+    std::size_t mSize{ 0 };
+    std::size_t mGrowthLeft{ 0 };
+    [[no_unique_address]] Hash mHash{};
+    [[no_unique_address]] KeyEqual mEqual{};
+};
@@ -0,0 +1,66 @@
+#include "frame_arena.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t const capacity) {
+    mBlocks.push_back(createBlock(std::max(capacity, std::size_t{ 1 })));
+}
+
+FrameArena& FrameArena::threadLocal() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::allocate(std::size_t const numBytes, std::size_t const alignment) {
+    assert(std::has_single_bit(alignment));
+    auto const& block = mBlocks.back();
+    auto const address = reinterpret_cast<std::uintptr_t>(block.memory.get()) + mOffset;
+    auto const padding = (alignment - address % alignment) % alignment;
+    if (padding + numBytes > block.size - mOffset) {
+        return allocateFromNextBlock(numBytes, alignment);
+    }
+    mOffset += padding + numBytes;
+    return block.memory.get() + (mOffset - numBytes);
+}
+
+void FrameArena::reset() noexcept {
+    mHighWaterMark = highWaterMark();
+    if (mBlocks.size() > 1) {
+        // the last frames didn't fit into the first block, replace all blocks by one that's large enough
+        mBlocks.clear();
+        mBlocks.push_back(createBlock(std::bit_ceil(mHighWaterMark)));
+    }
+    mOffset = 0;
+    mNumBytesInPreviousBlocks = 0;
+}
+
+std::size_t FrameArena::highWaterMark() const noexcept {
+    return std::max(mHighWaterMark, usedBytes());
+}
+
+std::size_t FrameArena::capacity() const noexcept {
+    auto result = std::size_t{ 0 };
+    for (auto const& block : mBlocks) {
+        result += block.size;
+    }
+    return result;
+}
+
+FrameArena::Block FrameArena::createBlock(std::size_t const size) {
+    return Block{ .memory{ std::make_unique_for_overwrite<std::byte[]>(size) }, .size{ size } };
+}
+
+void* FrameArena::allocateFromNextBlock(std::size_t const numBytes, std::size_t const alignment) {
+    mNumBytesInPreviousBlocks += mOffset;
+    mOffset = 0;
+    // the padding for the alignment can take up to alignment - 1 bytes
+    auto const requiredSize = numBytes + alignment - 1;
+    mBlocks.push_back(createBlock(std::max(mBlocks.back().size * 2, std::bit_ceil(requiredSize))));
+    return allocate(numBytes, alignment);
+}
+
+void* FrameArena::Resource::do_allocate(std::size_t const numBytes, std::size_t const alignment) {
+    return mArena.allocate(numBytes, alignment);
+}
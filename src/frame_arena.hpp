@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of a frame. Allocating is a pointer increment, reset()
+// releases everything at once. If a frame needs more than the capacity, additional blocks are allocated from the
+// heap and merged into one block of sufficient size on the next reset(), so a steady state never allocates.
+// Not thread-safe: every thread uses its own arena (see threadLocal()).
+class FrameArena final {
+public:
+    static constexpr std::size_t defaultCapacity = 256 * 1024;
+
+public:
+    explicit FrameArena(std::size_t capacity = defaultCapacity);
+    FrameArena(FrameArena const&) = delete;
+    FrameArena(FrameArena&&) = delete;
+    FrameArena& operator=(FrameArena const&) = delete;
+    FrameArena& operator=(FrameArena&&) = delete;
+    ~FrameArena() = default;
+
+    // Arena of the calling thread. It is reset at the end of every frame by the owner of the thread's frame loop
+    // (Application for the main thread, RenderThread for the render thread).
+    [[nodiscard]] static FrameArena& threadLocal();
+
+    [[nodiscard]] void* allocate(std::size_t numBytes, std::size_t alignment = alignof(std::max_align_t));
+
+    // destructors of arena allocated objects are never called
+    template<typename T>
+    [[nodiscard]] std::span<T> allocateArray(std::size_t const count) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        auto const elements = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(elements, count);
+        return std::span<T>{ elements, count };
+    }
+
+    template<typename T, typename... Args>
+    [[nodiscard]] T& create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        return *std::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+    }
+
+    // invalidates all allocations
+    void reset() noexcept;
+
+    // for std::pmr containers, deallocations are no-ops
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept {
+        return &mResource;
+    }
+    // bytes allocated since the last reset (including alignment padding)
+    [[nodiscard]] std::size_t usedBytes() const noexcept {
+        return mNumBytesInPreviousBlocks + mOffset;
+    }
+    // largest number of bytes used within one frame, a good value for the initial capacity
+    [[nodiscard]] std::size_t highWaterMark() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+
+private:
+    class Resource final : public std::pmr::memory_resource {
+    public:
+        explicit Resource(FrameArena& arena) noexcept : mArena{ arena } { }
+
+    private:
+        [[nodiscard]] void* do_allocate(std::size_t numBytes, std::size_t alignment) override;
+        void do_deallocate(void*, std::size_t, std::size_t) noexcept override { }
+        [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        FrameArena& mArena;
+    };
+
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+private:
+    [[nodiscard]] static Block createBlock(std::size_t size);
+    [[nodiscard]] void* allocateFromNextBlock(std::size_t numBytes, std::size_t alignment);
+
+private:
+    // allocations are made from the last block
+    std::vector<Block> mBlocks;
+    std::size_t mOffset{ 0 };
+    std::size_t mNumBytesInPreviousBlocks{ 0 };
+    std::size_t mHighWaterMark{ 0 };
+    Resource mResource{ *this };
+};
+
+// Cycles through NumBuffers arenas, one per frame, so that the data of a frame stays valid during the following
+// NumBuffers - 1 frames (e.g. data that is read by the GPU or another thread one frame later).
+template<std::size_t NumBuffers = 2>
+class BufferedFrameArena final {
+    static_assert(NumBuffers >= 2);
+
+public:
+    explicit BufferedFrameArena(std::size_t const capacity = FrameArena::defaultCapacity)
+        : mArenas{ createArenas(capacity, std::make_index_sequence<NumBuffers>{}) } { }
+
+    [[nodiscard]] FrameArena& current() noexcept {
+        return mArenas[mCurrentArena];
+    }
+    // switches to the arena that was used NumBuffers - 1 frames ago and resets it
+    void nextFrame() noexcept {
+        mCurrentArena = (mCurrentArena + 1) % NumBuffers;
+        mArenas[mCurrentArena].reset();
+    }
+    [[nodiscard]] std::size_t highWaterMark() const noexcept {
+        auto result = std::size_t{ 0 };
+        for (auto const& arena : mArenas) {
+            result = std::max(result, arena.highWaterMark());
+        }
+        return result;
+    }
+
+private:
+    template<std::size_t... Indices>
+    [[nodiscard]] static std::array<FrameArena, NumBuffers>
+    createArenas(std::size_t const capacity, std::index_sequence<Indices...>) {
+        return std::array<FrameArena, NumBuffers>{ (static_cast<void>(Indices), FrameArena{ capacity })... };
+    }
+
+private:
+    std::array<FrameArena, NumBuffers> mArenas;
+    std::size_t mCurrentArena{ 0 };
+};
@@ -0,0 +1,100 @@
+#include "frame_pacer.hpp"
+#include "scoped_timer.hpp"
+#include <GLFW/glfw3.h>
+#include <charconv>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+std::optional<FramePacingSettings> FramePacingSettings::parse(std::string_view const text) noexcept {
+    if (text == "unlimited") {
+        return FramePacingSettings{ .mode{ PacingMode::Unlimited } };
+    }
+    if (text == "vsync") {
+        return FramePacingSettings{ .mode{ PacingMode::VSync } };
+    }
+    if (text == "on-demand") {
+        return FramePacingSettings{ .mode{ PacingMode::OnDemand } };
+    }
+    auto framesPerSecond = 0.0;
+    auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), framesPerSecond);
+    if (error != std::errc{} || end != text.data() + text.size() || framesPerSecond <= 0.0) {
+        return std::nullopt;
+    }
+    return FramePacingSettings{ .mode{ PacingMode::TargetFrameRate }, .targetFramesPerSecond{ framesPerSecond } };
+}
+
+FramePacer::FramePacer(FramePacingSettings const& settings) noexcept : mSettings{ settings } { }
+
+void FramePacer::setSettings(FramePacingSettings const& settings) noexcept {
+    mSettings = settings;
+    if (glfwGetCurrentContext() != nullptr) {
+        glfwSwapInterval(settings.mode == PacingMode::VSync ? 1 : 0);
+    } else {
+        spdlog::warn("unable to change the swap interval, the context isn't current on this thread");
+    }
+    mNextFrameDeadline = Clock::now();
+    requestRedraw();
+}
+
+void FramePacer::requestRedraw() noexcept {
+    if (!mIsRedrawRequested.exchange(true)) {
+        // wakes up the main thread if it's blocked in glfwWaitEvents()
+        glfwPostEmptyEvent();
+    }
+}
+
+void FramePacer::waitForNextFrame() noexcept {
+    SCOPED_TIMER();
+    switch (mSettings.mode) {
+        case PacingMode::TargetFrameRate:
+            sleepUntilDeadline();
+            glfwPollEvents();
+            break;
+        case PacingMode::OnDemand:
+            waitForEvents();
+            break;
+        case PacingMode::Unlimited:
+        case PacingMode::VSync:
+        default:
+            glfwPollEvents();
+            break;
+    }
+}
+
+void FramePacer::sleepUntilDeadline() noexcept {
+    auto const frameDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>{ 1.0 / mSettings.targetFramesPerSecond }
+    );
+    mNextFrameDeadline += frameDuration;
+    auto const now = Clock::now();
+    if (mNextFrameDeadline < now) {
+        // too slow to keep up, don't try to catch up with the missed frames
+        mNextFrameDeadline = now;
+        return;
+    }
+    if (mNextFrameDeadline - now > spinDuration) {
+        std::this_thread::sleep_until(mNextFrameDeadline - spinDuration);
+    }
+    while (Clock::now() < mNextFrameDeadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::waitForEvents() noexcept {
+    if (mIsRedrawRequested.exchange(false)) {
+        mNumRemainingFrames = numFramesPerWakeUp;
+    }
+    if (mNumRemainingFrames > 0) {
+        --mNumRemainingFrames;
+        glfwPollEvents();
+        return;
+    }
+    if (mSettings.maxIdleDuration) {
+        glfwWaitEventsTimeout(*mSettings.maxIdleDuration);
+    } else {
+        glfwWaitEvents();
+    }
+    // woken up by input, a redraw request or the timeout: the next frames have to be rendered
+    mIsRedrawRequested = false;
+    mNumRemainingFrames = numFramesPerWakeUp - 1;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+enum class PacingMode {
+    // renders as fast as possible
+    Unlimited,
+    // waits for the vertical blank when presenting
+    VSync,
+    // sleeps between frames to reach FramePacingSettings::targetFramesPerSecond
+    TargetFrameRate,
+    // blocks until input arrives or a redraw is requested
+    OnDemand,
+};
+
+struct FramePacingSettings {
+    PacingMode mode{ PacingMode::Unlimited };
+    double targetFramesPerSecond{ 60.0 };
+    // in on-demand mode, a frame is rendered after this duration even without input (std::nullopt waits forever)
+    std::optional<double> maxIdleDuration{ 1.0 };
+
+    // "unlimited", "vsync", "on-demand" or a frame rate like "144"
+    [[nodiscard]] static std::optional<FramePacingSettings> parse(std::string_view text) noexcept;
+};
+
+// Replaces the plain glfwPollEvents() at the end of a frame: processes the pending events and waits as required by
+// the pacing mode.
+class FramePacer final {
+public:
+    // ImGui reacts to input one frame late, so every wake-up in on-demand mode renders a few frames
+    static constexpr std::uint32_t numFramesPerWakeUp = 2;
+
+public:
+    explicit FramePacer(FramePacingSettings const& settings = FramePacingSettings{}) noexcept;
+
+    // has to be called while the window's context is current on the calling thread (it sets the swap interval)
+    void setSettings(FramePacingSettings const& settings) noexcept;
+    [[nodiscard]] FramePacingSettings const& settings() const noexcept {
+        return mSettings;
+    }
+    // marks the content as dirty in on-demand mode; can be called from any thread
+    void requestRedraw() noexcept;
+    void waitForNextFrame() noexcept;
+
+private:
+    void sleepUntilDeadline() noexcept;
+    void waitForEvents() noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // sleeping is only precise to about a millisecond, the rest of the time is spent spinning
+    static constexpr auto spinDuration = std::chrono::microseconds{ 1500 };
+
+    FramePacingSettings mSettings;
+    Clock::time_point mNextFrameDeadline{ Clock::now() };
+    std::atomic_bool mIsRedrawRequested{ true };
+    std::uint32_t mNumRemainingFrames{ numFramesPerWakeUp };
+};
@@ -0,0 +1,204 @@
+#include "frame_statistics.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+namespace {
+    [[nodiscard]] double secondsSince(std::chrono::steady_clock::time_point const startTime) noexcept {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    // nearest-rank percentile of sorted values
+    [[nodiscard]] double percentile(std::vector<double> const& sortedValues, double const fraction) noexcept {
+        auto const rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sortedValues.size())));
+        return sortedValues[std::clamp(rank, std::size_t{ 1 }, sortedValues.size()) - 1];
+    }
+
+    [[nodiscard]] float toMilliseconds(double const seconds) noexcept {
+        return static_cast<float>(seconds * 1000.0);
+    }
+} // namespace
+
+std::string_view toString(FramePhase const phase) noexcept {
+    switch (phase) {
+        case FramePhase::ImGui:
+            return "ImGui";
+        case FramePhase::Simulation:
+            return "simulation";
+        case FramePhase::Update:
+            return "update";
+        case FramePhase::Flush:
+            return "flush";
+        case FramePhase::Present:
+            return "present";
+        case FramePhase::Wait:
+            return "wait";
+    }
+    return "unknown";
+}
+
+FrameStatistics::PhaseTimer::PhaseTimer(FrameStatistics& statistics, FramePhase const phase) noexcept
+    : mStatistics{ statistics },
+      mPhase{ phase },
+      mStartTime{ std::chrono::steady_clock::now() } { }
+
+FrameStatistics::PhaseTimer::~PhaseTimer() {
+    mStatistics.addPhaseDuration(mPhase, secondsSince(mStartTime));
+}
+
+void FrameStatistics::beginFrame() noexcept {
+    mCurrentFrame = FrameTimings{};
+    mFrameStartTime = std::chrono::steady_clock::now();
+}
+
+void FrameStatistics::addPhaseDuration(FramePhase const phase, double const duration) noexcept {
+    mCurrentFrame.phaseDurations[static_cast<std::size_t>(phase)] += duration;
+}
+
+void FrameStatistics::endFrame(std::optional<double> const gpuDuration) noexcept {
+    mCurrentFrame.cpuDuration = secondsSince(mFrameStartTime);
+    mCurrentFrame.gpuDuration = gpuDuration;
+    mFrames[mNextIndex] = mCurrentFrame;
+    mNextIndex = (mNextIndex + 1) % historySize;
+    mNumFrames = std::min(mNumFrames + 1, historySize);
+}
+
+FrameTimings const& FrameStatistics::frame(std::size_t const age) const noexcept {
+    assert(age < mNumFrames);
+    return mFrames[(mNextIndex + historySize - 1 - age) % historySize];
+}
+
+template<typename Selector>
+FrameTimePercentiles FrameStatistics::percentiles(Selector selector) const {
+    mScratchValues.clear();
+    for (std::size_t age = 0; age < mNumFrames; ++age) {
+        if (auto const value = selector(frame(age)); value) {
+            mScratchValues.push_back(*value);
+        }
+    }
+    if (mScratchValues.empty()) {
+        return FrameTimePercentiles{};
+    }
+    std::ranges::sort(mScratchValues);
+    return FrameTimePercentiles{ .p50{ percentile(mScratchValues, 0.5) },
+                                 .p95{ percentile(mScratchValues, 0.95) },
+                                 .p99{ percentile(mScratchValues, 0.99) },
+                                 .max{ mScratchValues.back() } };
+}
+
+FrameTimePercentiles FrameStatistics::cpuPercentiles() const {
+    return percentiles([](FrameTimings const& timings) { return std::optional{ timings.cpuDuration }; });
+}
+
+std::optional<FrameTimePercentiles> FrameStatistics::gpuPercentiles() const {
+    auto const result = percentiles([](FrameTimings const& timings) { return timings.gpuDuration; });
+    if (mScratchValues.empty()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+FrameTimePercentiles FrameStatistics::phasePercentiles(FramePhase const phase) const {
+    return percentiles([phase](FrameTimings const& timings) { return std::optional{ timings.phaseDuration(phase) }; }
+    );
+}
+
+std::vector<std::uint32_t> FrameStatistics::histogram(std::size_t const numBins, double const maxDuration) const {
+    assert(numBins > 0 && maxDuration > 0.0);
+    auto result = std::vector<std::uint32_t>(numBins, 0U);
+    for (std::size_t age = 0; age < mNumFrames; ++age) {
+        auto const bin = static_cast<std::size_t>(frame(age).cpuDuration / maxDuration * static_cast<double>(numBins));
+        ++result[std::min(bin, numBins - 1)];
+    }
+    return result;
+}
+
+void FrameStatistics::renderOverlay(bool* const isOpen) const {
+    ImGui::SetNextWindowBgAlpha(0.8f);
+    if (!ImGui::Begin("Frame statistics", isOpen, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::End();
+        return;
+    }
+    if (mNumFrames == 0) {
+        ImGui::TextUnformatted("no frames recorded yet");
+        ImGui::End();
+        return;
+    }
+
+    auto const cpu = cpuPercentiles();
+    ImGui::Text(
+            "CPU  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+            static_cast<double>(toMilliseconds(cpu.p50)),
+            static_cast<double>(toMilliseconds(cpu.p95)),
+            static_cast<double>(toMilliseconds(cpu.p99)),
+            static_cast<double>(toMilliseconds(cpu.max))
+    );
+    if (auto const gpu = gpuPercentiles()) {
+        ImGui::Text(
+                "GPU  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+                static_cast<double>(toMilliseconds(gpu->p50)),
+                static_cast<double>(toMilliseconds(gpu->p95)),
+                static_cast<double>(toMilliseconds(gpu->p99)),
+                static_cast<double>(toMilliseconds(gpu->max))
+        );
+    } else {
+        ImGui::TextUnformatted("GPU  not available (requires ENABLE_PROFILING)");
+    }
+
+    // oldest frame on the left
+    auto const frameTimeGetter = [](void* const data, int const index) {
+        auto const& self = *static_cast<FrameStatistics const*>(data);
+        return toMilliseconds(self.frame(self.mNumFrames - 1 - static_cast<std::size_t>(index)).cpuDuration);
+    };
+    ImGui::PlotLines(
+            "##frame times",
+            frameTimeGetter,
+            const_cast<FrameStatistics*>(this),
+            static_cast<int>(mNumFrames),
+            0,
+            "frame time (ms)",
+            0.0f,
+            toMilliseconds(cpu.max),
+            ImVec2{ 400.0f, 80.0f }
+    );
+
+    static constexpr std::size_t numHistogramBins = 40;
+    auto const bins = histogram(numHistogramBins, cpu.max * 1.001);
+    auto binValues = std::array<float, numHistogramBins>{};
+    std::ranges::transform(bins, binValues.begin(), [](std::uint32_t const count) {
+        return static_cast<float>(count);
+    });
+    auto const histogramLabel = fmt::format("0 .. {:.1f} ms", cpu.max * 1000.0);
+    ImGui::PlotHistogram(
+            "##histogram",
+            binValues.data(),
+            static_cast<int>(binValues.size()),
+            0,
+            histogramLabel.c_str(),
+            0.0f,
+            FLT_MAX,
+            ImVec2{ 400.0f, 60.0f }
+    );
+
+    if (ImGui::BeginTable("phases", 3, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("phase");
+        ImGui::TableSetupColumn("p50 (ms)");
+        ImGui::TableSetupColumn("p95 (ms)");
+        ImGui::TableHeadersRow();
+        for (std::size_t i = 0; i < numFramePhases; ++i) {
+            auto const phase = static_cast<FramePhase>(i);
+            auto const phasePercentiles = this->phasePercentiles(phase);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(toString(phase).data());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(toMilliseconds(phasePercentiles.p50)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(toMilliseconds(phasePercentiles.p95)));
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+enum class FramePhase : std::size_t {
+    ImGui,
+    Simulation,
+    Update,
+    // Renderer::endFrame() (measured by the renderer, only available without render thread)
+    Flush,
+    // buffer swap or, with the render thread, frame submission
+    Present,
+    // frame pacing and waiting for a free frame in flight
+    Wait,
+};
+
+inline constexpr std::size_t numFramePhases = 6;
+
+[[nodiscard]] std::string_view toString(FramePhase phase) noexcept;
+
+// all durations in seconds
+struct FrameTimings {
+    // wall clock time of the whole frame, including all waiting
+    double cpuDuration{ 0.0 };
+    // GPU time of the instrumented scopes (see GpuTimer), lags a few frames behind
+    std::optional<double> gpuDuration;
+    std::array<double, numFramePhases> phaseDurations{};
+
+    [[nodiscard]] double phaseDuration(FramePhase const phase) const noexcept {
+        return phaseDurations[static_cast<std::size_t>(phase)];
+    }
+};
+
+struct FrameTimePercentiles {
+    double p50{ 0.0 };
+    double p95{ 0.0 };
+    double p99{ 0.0 };
+    double max{ 0.0 };
+};
+
+// Keeps the timings of the last historySize frames in a ring buffer.
+class FrameStatistics final {
+public:
+    static constexpr std::size_t historySize = 512;
+
+    class PhaseTimer final {
+    public:
+        PhaseTimer(FrameStatistics& statistics, FramePhase phase) noexcept;
+        PhaseTimer(PhaseTimer const&) = delete;
+        PhaseTimer(PhaseTimer&&) = delete;
+        PhaseTimer& operator=(PhaseTimer const&) = delete;
+        PhaseTimer& operator=(PhaseTimer&&) = delete;
+        ~PhaseTimer();
+
+    private:
+        FrameStatistics& mStatistics;
+        FramePhase mPhase;
+        std::chrono::steady_clock::time_point mStartTime;
+    };
+
+public:
+    void beginFrame() noexcept;
+    // durations of the same phase within a frame are accumulated
+    void addPhaseDuration(FramePhase phase, double duration) noexcept;
+    [[nodiscard]] PhaseTimer measurePhase(FramePhase const phase) noexcept {
+        return PhaseTimer{ *this, phase };
+    }
+    void endFrame(std::optional<double> gpuDuration) noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mNumFrames;
+    }
+    // age 0 is the most recently finished frame
+    [[nodiscard]] FrameTimings const& frame(std::size_t age) const noexcept;
+
+    [[nodiscard]] FrameTimePercentiles cpuPercentiles() const;
+    [[nodiscard]] std::optional<FrameTimePercentiles> gpuPercentiles() const;
+    [[nodiscard]] FrameTimePercentiles phasePercentiles(FramePhase phase) const;
+    // frame counts of numBins equally sized CPU frame time ranges between 0 and maxDuration (the last bin also
+    // contains all longer frames)
+    [[nodiscard]] std::vector<std::uint32_t> histogram(std::size_t numBins, double maxDuration) const;
+
+    void renderOverlay(bool* isOpen) const;
+
+private:
+    template<typename Selector>
+    [[nodiscard]] FrameTimePercentiles percentiles(Selector selector) const;
+
+private:
+    std::array<FrameTimings, historySize> mFrames{};
+    std::size_t mNumFrames{ 0 };
+    std::size_t mNextIndex{ 0 };
+    FrameTimings mCurrentFrame;
+    std::chrono::steady_clock::time_point mFrameStartTime;
+    // reused by the percentile calculations to avoid allocations
+    mutable std::vector<double> mScratchValues;
+};
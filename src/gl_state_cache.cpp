@@ -0,0 +1,226 @@
+#include "gl_state_cache.hpp"
+
+GLStateCache& GLStateCache::instance() noexcept {
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::useProgram(GLuint const programName) noexcept {
+    if (update(mProgram, programName)) {
+        glUseProgram(programName);
+    }
+}
+
+void GLStateCache::bindVertexArray(GLuint const vertexArrayName) noexcept {
+    if (update(mVertexArray, vertexArrayName)) {
+        glBindVertexArray(vertexArrayName);
+        // the element array buffer binding is part of the vertex array state
+        mElementArrayBuffer.reset();
+    }
+}
+
+void GLStateCache::bindBuffer(GLenum const target, GLuint const bufferName) noexcept {
+    auto const binding = bufferBinding(target);
+    if (binding == nullptr) {
+        ++mCurrentFrameStats.numIssuedCalls;
+        glBindBuffer(target, bufferName);
+        return;
+    }
+    if (update(*binding, bufferName)) {
+        glBindBuffer(target, bufferName);
+    }
+}
+
+void GLStateCache::bindBufferBase(GLenum const target, GLuint const index, GLuint const bufferName) noexcept {
+    auto const binding = indexedBufferBinding(target, index);
+    if (binding != nullptr && *binding == bufferName) {
+        ++mCurrentFrameStats.numElidedCalls;
+        return;
+    }
+    ++mCurrentFrameStats.numIssuedCalls;
+    glBindBufferBase(target, index, bufferName);
+    if (binding != nullptr) {
+        *binding = bufferName;
+    }
+    // glBindBufferBase also changes the generic binding point of the target
+    if (auto const genericBinding = bufferBinding(target); genericBinding != nullptr) {
+        *genericBinding = bufferName;
+    }
+}
+
+void GLStateCache::bindTextureUnit(GLuint const unit, GLuint const textureName) noexcept {
+    if (unit >= numTrackedTextureUnits) {
+        ++mCurrentFrameStats.numIssuedCalls;
+        glBindTextureUnit(unit, textureName);
+        return;
+    }
+    if (update(mTextureUnits[unit], textureName)) {
+        glBindTextureUnit(unit, textureName);
+    }
+}
+
+void GLStateCache::bindSampler(GLuint const unit, GLuint const samplerName) noexcept {
+    if (unit >= numTrackedTextureUnits) {
+        ++mCurrentFrameStats.numIssuedCalls;
+        glBindSampler(unit, samplerName);
+        return;
+    }
+    if (update(mSamplers[unit], samplerName)) {
+        glBindSampler(unit, samplerName);
+    }
+}
+
+void GLStateCache::bindFramebuffer(GLuint const framebufferName) noexcept {
+    if (update(mFramebuffer, framebufferName)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebufferName);
+    }
+}
+
+void GLStateCache::setBlendEnabled(bool const enabled) noexcept {
+    if (update(mBlendEnabled, enabled)) {
+        enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+    }
+}
+
+void GLStateCache::setBlendFunction(GLenum const sourceFactor, GLenum const destinationFactor) noexcept {
+    if (update(mBlendFunction, BlendFunction{ sourceFactor, destinationFactor })) {
+        glBlendFunc(sourceFactor, destinationFactor);
+    }
+}
+
+void GLStateCache::setDepthTestEnabled(bool const enabled) noexcept {
+    if (update(mDepthTestEnabled, enabled)) {
+        enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+    }
+}
+
+void GLStateCache::setDepthMask(bool const enabled) noexcept {
+    if (update(mDepthMask, enabled)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLStateCache::setDepthFunction(GLenum const function) noexcept {
+    if (update(mDepthFunction, function)) {
+        glDepthFunc(function);
+    }
+}
+
+void GLStateCache::setViewport(GLint const x, GLint const y, GLsizei const width, GLsizei const height) noexcept {
+    if (update(mViewport, Viewport{ x, y, width, height })) {
+        glViewport(x, y, width, height);
+    }
+}
+
+void GLStateCache::onProgramDeleted(GLuint const programName) noexcept {
+    // a program that is in use stays current until another program is used
+    if (mProgram == programName) {
+        mProgram.reset();
+    }
+}
+
+void GLStateCache::onVertexArrayDeleted(GLuint const vertexArrayName) noexcept {
+    if (mVertexArray == vertexArrayName) {
+        mVertexArray = 0U;
+        mElementArrayBuffer.reset();
+    }
+}
+
+void GLStateCache::onBufferDeleted(GLuint const bufferName) noexcept {
+    auto const resetIfBound = [bufferName](OptionalName& binding) {
+        if (binding == bufferName) {
+            binding = 0U;
+        }
+    };
+    resetIfBound(mArrayBuffer);
+    resetIfBound(mElementArrayBuffer);
+    resetIfBound(mDrawIndirectBuffer);
+    resetIfBound(mUniformBuffer);
+    resetIfBound(mShaderStorageBuffer);
+    for (auto& binding : mUniformBufferBindings) {
+        resetIfBound(binding);
+    }
+    for (auto& binding : mShaderStorageBufferBindings) {
+        resetIfBound(binding);
+    }
+}
+
+void GLStateCache::onTextureDeleted(GLuint const textureName) noexcept {
+    for (auto& binding : mTextureUnits) {
+        if (binding == textureName) {
+            binding = 0U;
+        }
+    }
+}
+
+void GLStateCache::onSamplerDeleted(GLuint const samplerName) noexcept {
+    for (auto& binding : mSamplers) {
+        if (binding == samplerName) {
+            binding = 0U;
+        }
+    }
+}
+
+void GLStateCache::onFramebufferDeleted(GLuint const framebufferName) noexcept {
+    // deleting the bound framebuffer reverts the binding to the default framebuffer
+    if (mFramebuffer == framebufferName) {
+        mFramebuffer = 0U;
+    }
+}
+
+void GLStateCache::invalidate() noexcept {
+    mProgram.reset();
+    mVertexArray.reset();
+    mArrayBuffer.reset();
+    mElementArrayBuffer.reset();
+    mDrawIndirectBuffer.reset();
+    mUniformBuffer.reset();
+    mShaderStorageBuffer.reset();
+    mUniformBufferBindings.fill(std::nullopt);
+    mShaderStorageBufferBindings.fill(std::nullopt);
+    mTextureUnits.fill(std::nullopt);
+    mSamplers.fill(std::nullopt);
+    mFramebuffer.reset();
+    mBlendEnabled.reset();
+    mBlendFunction.reset();
+    mDepthTestEnabled.reset();
+    mDepthMask.reset();
+    mDepthFunction.reset();
+    mViewport.reset();
+}
+
+void GLStateCache::nextFrame() noexcept {
+    mLastFrameStats = mCurrentFrameStats;
+    mCurrentFrameStats = GLStateStats{};
+}
+
+std::optional<GLuint>* GLStateCache::bufferBinding(GLenum const target) noexcept {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return &mArrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return &mElementArrayBuffer;
+        case GL_DRAW_INDIRECT_BUFFER:
+            return &mDrawIndirectBuffer;
+        case GL_UNIFORM_BUFFER:
+            return &mUniformBuffer;
+        case GL_SHADER_STORAGE_BUFFER:
+            return &mShaderStorageBuffer;
+        default:
+            return nullptr;
+    }
+}
+
+std::optional<GLuint>* GLStateCache::indexedBufferBinding(GLenum const target, GLuint const index) noexcept {
+    if (index >= numTrackedIndexedBindings) {
+        return nullptr;
+    }
+    switch (target) {
+        case GL_UNIFORM_BUFFER:
+            return &mUniformBufferBindings[index];
+        case GL_SHADER_STORAGE_BUFFER:
+            return &mShaderStorageBufferBindings[index];
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+#include <optional>
+
+struct GLStateStats {
+    std::uint64_t numIssuedCalls{ 0ULL };
+    std::uint64_t numElidedCalls{ 0ULL };
+};
+
+// Shadows the OpenGL state that is changed by the engine so that redundant state changes can be skipped.
+// All engine code has to change the tracked state through this class, otherwise the cache gets out of sync
+// (call invalidate() after foreign code modified the state without restoring it).
+class GLStateCache final {
+public:
+    static constexpr std::size_t numTrackedTextureUnits = 32;
+    static constexpr std::size_t numTrackedIndexedBindings = 16;
+
+    struct Viewport {
+        GLint x;
+        GLint y;
+        GLsizei width;
+        GLsizei height;
+
+        [[nodiscard]] bool operator==(Viewport const&) const = default;
+    };
+
+    struct BlendFunction {
+        GLenum sourceFactor;
+        GLenum destinationFactor;
+
+        [[nodiscard]] bool operator==(BlendFunction const&) const = default;
+    };
+
+public:
+    GLStateCache(GLStateCache const&) = delete;
+    GLStateCache(GLStateCache&&) = delete;
+    GLStateCache& operator=(GLStateCache const&) = delete;
+    GLStateCache& operator=(GLStateCache&&) = delete;
+
+    [[nodiscard]] static GLStateCache& instance() noexcept;
+
+    void useProgram(GLuint programName) noexcept;
+    void bindVertexArray(GLuint vertexArrayName) noexcept;
+    void bindBuffer(GLenum target, GLuint bufferName) noexcept;
+    void bindBufferBase(GLenum target, GLuint index, GLuint bufferName) noexcept;
+    void bindTextureUnit(GLuint unit, GLuint textureName) noexcept;
+    void bindSampler(GLuint unit, GLuint samplerName) noexcept;
+    // binds the framebuffer for both drawing and reading
+    void bindFramebuffer(GLuint framebufferName) noexcept;
+    void setBlendEnabled(bool enabled) noexcept;
+    void setBlendFunction(GLenum sourceFactor, GLenum destinationFactor) noexcept;
+    void setDepthTestEnabled(bool enabled) noexcept;
+    void setDepthMask(bool enabled) noexcept;
+    void setDepthFunction(GLenum function) noexcept;
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height) noexcept;
+
+    // deleting an object implicitly unbinds it, so the cache has to forget about it
+    void onProgramDeleted(GLuint programName) noexcept;
+    void onVertexArrayDeleted(GLuint vertexArrayName) noexcept;
+    void onBufferDeleted(GLuint bufferName) noexcept;
+    void onTextureDeleted(GLuint textureName) noexcept;
+    void onSamplerDeleted(GLuint samplerName) noexcept;
+    void onFramebufferDeleted(GLuint framebufferName) noexcept;
+
+    void invalidate() noexcept;
+    void nextFrame() noexcept;
+    [[nodiscard]] GLStateStats const& currentFrameStats() const noexcept {
+        return mCurrentFrameStats;
+    }
+    [[nodiscard]] GLStateStats const& lastFrameStats() const noexcept {
+        return mLastFrameStats;
+    }
+
+private:
+    GLStateCache() = default;
+
+    template<typename T>
+    [[nodiscard]] bool update(std::optional<T>& cached, T const& value) noexcept {
+        if (cached == value) {
+            ++mCurrentFrameStats.numElidedCalls;
+            return false;
+        }
+        cached = value;
+        ++mCurrentFrameStats.numIssuedCalls;
+        return true;
+    }
+
+    [[nodiscard]] std::optional<GLuint>* bufferBinding(GLenum target) noexcept;
+    [[nodiscard]] std::optional<GLuint>* indexedBufferBinding(GLenum target, GLuint index) noexcept;
+
+private:
+    using OptionalName = std::optional<GLuint>;
+
+    OptionalName mProgram;
+    OptionalName mVertexArray;
+    OptionalName mArrayBuffer;
+    OptionalName mElementArrayBuffer;
+    OptionalName mDrawIndirectBuffer;
+    OptionalName mUniformBuffer;
+    OptionalName mShaderStorageBuffer;
+    std::array<OptionalName, numTrackedIndexedBindings> mUniformBufferBindings;
+    std::array<OptionalName, numTrackedIndexedBindings> mShaderStorageBufferBindings;
+    std::array<OptionalName, numTrackedTextureUnits> mTextureUnits;
+    std::array<OptionalName, numTrackedTextureUnits> mSamplers;
+    OptionalName mFramebuffer;
+    std::optional<bool> mBlendEnabled;
+    std::optional<BlendFunction> mBlendFunction;
+    std::optional<bool> mDepthTestEnabled;
+    std::optional<bool> mDepthMask;
+    std::optional<GLenum> mDepthFunction;
+    std::optional<Viewport> mViewport;
+    GLStateStats mCurrentFrameStats;
+    GLStateStats mLastFrameStats;
+};
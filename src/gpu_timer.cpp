@@ -0,0 +1,140 @@
+#include "gpu_timer.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <gsl/gsl>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+GpuTimer::GpuTimer(char const* name, std::source_location sourceLocation) noexcept
+    : mScopeIndex{ sFrames[sCurrentFrame].scopes.size() } {
+    auto const beginQuery = acquireQuery();
+    glQueryCounter(beginQuery, GL_TIMESTAMP);
+    sFrames[sCurrentFrame].scopes.push_back(Scope{ .name{ name },
+                                                   .sourceLocation{ sourceLocation },
+                                                   .depth{ sCurrentDepth },
+                                                   .beginQuery{ beginQuery },
+                                                   .endQuery{ 0U } });
+    ++sCurrentDepth;
+}
+
+GpuTimer::~GpuTimer() {
+    --sCurrentDepth;
+    auto const endQuery = acquireQuery();
+    glQueryCounter(endQuery, GL_TIMESTAMP);
+    sFrames[sCurrentFrame].scopes[mScopeIndex].endQuery = endQuery;
+}
+
+void GpuTimer::nextFrame() noexcept {
+    sCurrentFrame = (sCurrentFrame + 1) % numFramesInFlight;
+    // the queries of this slot have been issued numFramesInFlight frames ago
+    collectResults(sFrames[sCurrentFrame]);
+}
+
+GLuint GpuTimer::acquireQuery() noexcept {
+    auto& frame = sFrames[sCurrentFrame];
+    if (frame.numUsedQueries == frame.queries.size()) {
+        auto const numNewQueries = std::max(frame.queries.size(), std::size_t{ 16 });
+        frame.queries.resize(frame.queries.size() + numNewQueries);
+        glCreateQueries(
+                GL_TIMESTAMP,
+                gsl::narrow_cast<GLsizei>(numNewQueries),
+                frame.queries.data() + frame.numUsedQueries
+        );
+    }
+    return frame.queries[frame.numUsedQueries++];
+}
+
+void GpuTimer::collectResults(FrameQueries& frame) noexcept {
+    if (frame.scopes.empty()) {
+        return;
+    }
+    // queries complete in order, so the last one tells whether the whole frame is available
+    GLuint isAvailable = GL_FALSE;
+    glGetQueryObjectuiv(frame.queries[frame.numUsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    if (isAvailable == GL_FALSE) {
+        ++sNumDroppedFrames;
+    } else {
+        auto frameBeginTime = std::numeric_limits<GLuint64>::max();
+        auto frameEndTime = GLuint64{ 0 };
+        for (auto const& scope : frame.scopes) {
+            GLuint64 beginTime = 0;
+            GLuint64 endTime = 0;
+            glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &beginTime);
+            glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &endTime);
+            frameBeginTime = std::min(frameBeginTime, beginTime);
+            frameEndTime = std::max(frameEndTime, endTime);
+            auto const duration = static_cast<double>(endTime - beginTime) / 1'000'000'000.0;
+
+            auto const filename = std::filesystem::path(scope.sourceLocation.file_name()).filename().string();
+            auto const locationString = fmt::format(
+                    "[{}, {}]{}",
+                    filename,
+                    scope.sourceLocation.line(),
+                    *scope.name == '\0' ? scope.sourceLocation.function_name() : scope.name
+            );
+            auto const [iterator, inserted] = sMeasurements.try_emplace(
+                    locationString,
+                    Measurement{ .count = 1,
+                                 .depth = scope.depth,
+                                 .minDuration = duration,
+                                 .maxDuration = duration,
+                                 .totalDuration = duration,
+                                 .numAllocations = 0,
+                                 .numAllocatedBytes = 0 }
+            );
+            if (!inserted) {
+                auto& measurement = iterator->second;
+                ++measurement.count;
+                measurement.minDuration = std::min(measurement.minDuration, duration);
+                measurement.maxDuration = std::max(measurement.maxDuration, duration);
+                measurement.totalDuration += duration;
+            }
+        }
+        sLastFrameDuration = static_cast<double>(frameEndTime - frameBeginTime) / 1'000'000'000.0;
+    }
+    frame.scopes.clear();
+    frame.numUsedQueries = 0;
+}
+
+std::optional<double> GpuTimer::lastFrameDuration() noexcept {
+    auto const duration = sLastFrameDuration.load();
+    if (duration < 0.0) {
+        return std::nullopt;
+    }
+    return duration;
+}
+
+void GpuTimer::logResults() noexcept {
+#if ENABLE_PROFILING
+    std::vector<std::pair<std::string, Measurement>> measurements{ sMeasurements.cbegin(), sMeasurements.cend() };
+    std::sort(measurements.begin(), measurements.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.second.totalDuration > rhs.second.totalDuration;
+    });
+    spdlog::info("=== GPU Measurement Summary (all times in ms) ===");
+    for (auto const& dataPoint : measurements) {
+        spdlog::info(
+                "{:->{}}{}|{:.3f} ({}x)|AVG:{:.3f}|MIN: {:.3f}|MAX: {:.3f}",
+                "",
+                dataPoint.second.depth,
+                dataPoint.first,
+                dataPoint.second.totalDuration * 1000.0,
+                dataPoint.second.count,
+                dataPoint.second.totalDuration * 1000.0 / gsl::narrow_cast<double>(dataPoint.second.count),
+                dataPoint.second.minDuration * 1000.0,
+                dataPoint.second.maxDuration * 1000.0
+        );
+    }
+    if (sNumDroppedFrames > 0) {
+        spdlog::info("{} frames were dropped because their GPU results were not available in time", sNumDroppedFrames);
+    }
+#endif
+}
+
+void GpuTimer::releaseQueries() noexcept {
+    for (auto& frame : sFrames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(gsl::narrow_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+        frame = FrameQueries{};
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "flat_hash_map.hpp"
+#include "scoped_timer.hpp"
+
+#if ENABLE_PROFILING
+#define GPU_SCOPED_TIMER_LINE2(line) \
+    GpuTimer _gpu_scoped_Timer##line { }
+#define GPU_SCOPED_TIMER_LINE(line) GPU_SCOPED_TIMER_LINE2(line)
+#define GPU_SCOPED_TIMER() GPU_SCOPED_TIMER_LINE(__LINE__)
+#define GPU_SCOPED_TIMER_NAMED_LINE2(name, line) \
+    GpuTimer _gpu_scoped_Timer##line {           \
+        name                                     \
+    }
+#define GPU_SCOPED_TIMER_NAMED_LINE(name, line) GPU_SCOPED_TIMER_NAMED_LINE2(name, line)
+#define GPU_SCOPED_TIMER_NAMED(name) GPU_SCOPED_TIMER_NAMED_LINE(name, __LINE__)
+#else
+#define GPU_SCOPED_TIMER()
+#define GPU_SCOPED_TIMER_NAMED(name)
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <vector>
+
+// Measures the time the GPU spends executing the commands issued inside of a scope. Both ends of the scope
+// write a GL_TIMESTAMP query (so scopes can be nested, unlike GL_TIME_ELAPSED queries) and the results are
+// read back numFramesInFlight frames later to never stall the pipeline.
+class GpuTimer final {
+public:
+    using Measurement = ScopedTimer::Measurement;
+    static constexpr std::size_t numFramesInFlight = 3;
+
+public:
+    explicit
+    GpuTimer(char const* name = "", std::source_location sourceLocation = std::source_location::current()) noexcept;
+    GpuTimer(GpuTimer const&) = delete;
+    GpuTimer(GpuTimer&&) = delete;
+    GpuTimer& operator=(GpuTimer const&) = delete;
+    GpuTimer& operator=(GpuTimer&&) = delete;
+    ~GpuTimer();
+
+    // has to be called once per frame (after swapping the buffers)
+    static void nextFrame() noexcept;
+    static void logResults() noexcept;
+    // time between the first and the last timestamp of the most recently collected frame (in seconds)
+    [[nodiscard]] static std::optional<double> lastFrameDuration() noexcept;
+    // has to be called while the OpenGL context is still alive
+    static void releaseQueries() noexcept;
+
+private:
+    struct Scope {
+        char const* name;
+        std::source_location sourceLocation;
+        std::uint64_t depth;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+
+    struct FrameQueries {
+        std::vector<GLuint> queries;
+        std::size_t numUsedQueries;
+        std::vector<Scope> scopes;
+    };
+
+    [[nodiscard]] static GLuint acquireQuery() noexcept;
+    static void collectResults(FrameQueries& frame) noexcept;
+
+private:
+    std::size_t mScopeIndex;
+    static inline std::array<FrameQueries, numFramesInFlight> sFrames{};
+    static inline std::size_t sCurrentFrame{ 0 };
+    static inline std::uint64_t sCurrentDepth{ 0ULL };
+    static inline std::uint64_t sNumDroppedFrames{ 0ULL };
+    // negative while unavailable; atomic because the render thread writes while the main thread reads
+    static inline std::atomic<double> sLastFrameDuration{ -1.0 };
+    static inline FlatHashMap<std::string, Measurement> sMeasurements{};
+};
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "hash/hash.hpp"
+#include "xoshiro256.hpp"
 #include <algorithm>
 #include <cstdint>
+#include <iomanip>
 #include <iterator>
 #include <random>
 #include <spdlog/spdlog.h>
@@ -22,8 +25,9 @@ struct GUID {
 
     [[nodiscard]] static GUID create() noexcept {
         GUID result;
-        result.mHigh = mDistribution(mRandomGenerator);
-        result.mLow = mDistribution(mRandomGenerator);
+        auto& generator = randomGenerator();
+        result.mHigh = generator();
+        result.mLow = generator();
         return result;
     }
 
@@ -56,9 +60,14 @@ struct GUID {
     }
 
 private:
-    static inline std::random_device mRandomDevice{};
-    static inline std::mt19937_64 mRandomGenerator{ mRandomDevice() };
-    static inline std::uniform_int_distribution<std::uint64_t> mDistribution{};
+    // one generator per thread, so that GUIDs can be created concurrently
+    [[nodiscard]] static Xoshiro256StarStar& randomGenerator() noexcept {
+        thread_local auto generator = [] {
+            auto randomDevice = std::random_device{};
+            return Xoshiro256StarStar{ (static_cast<std::uint64_t>(randomDevice()) << 32U) ^ randomDevice() };
+        }();
+        return generator;
+    }
 
     std::uint64_t mHigh{ 0 }, mLow{ 0 };
 };
@@ -81,7 +90,7 @@ namespace std {
     template<>
     struct hash<GUID> {
         size_t operator()(const GUID& guid) const noexcept {
-            return guid.low() ^ guid.high();
+            return ::hash::hash128To64(guid.high(), guid.low());
         }
     };
 
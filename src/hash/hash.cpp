@@ -2,7 +2,7 @@
 #include <utility>
 
 namespace hash {
-    std::unordered_map<std::size_t, std::string> cachedHashNames;
+    FlatHashMap<std::size_t, std::string> cachedHashNames;
 
     std::string_view getStringFromHash(std::size_t hash) noexcept {
         auto const it = cachedHashNames.find(hash);
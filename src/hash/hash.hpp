@@ -1,10 +1,11 @@
 #pragma once
 
 
+#include "flat_hash_map.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 
 namespace hash {
     // https://stackoverflow.com/questions/48896142/is-it-possible-to-get-hash-values-as-compile-time-constants
@@ -13,7 +14,7 @@ namespace hash {
 #ifdef DEBUG_BUILD
     [[nodiscard]] std::string_view getStringFromHash(std::size_t hash) noexcept;
 
-    extern std::unordered_map<std::size_t, std::string> cachedHashNames;
+    extern FlatHashMap<std::size_t, std::string> cachedHashNames;
 
     namespace {
         void cacheHashName(std::size_t hash, std::string const& name) noexcept {
@@ -22,6 +23,17 @@ namespace hash {
     } // namespace
 #endif
 
+    // Reduces a 128 bit value (e.g. a GUID) to 64 bits so that every input bit affects the result
+    // (Hash128to64 from CityHash). Simply xor-ing both halves maps all values with equal halves to zero.
+    [[nodiscard]] constexpr std::uint64_t hash128To64(std::uint64_t const high, std::uint64_t const low) noexcept {
+        constexpr auto multiplier = std::uint64_t{ 0x9DDF'EA08'EB38'2D69ULL };
+        auto a = (low ^ high) * multiplier;
+        a ^= (a >> 47U);
+        auto b = (high ^ a) * multiplier;
+        b ^= (b >> 47U);
+        return b * multiplier;
+    }
+
     template<typename Str>
     size_t hashString(Str const& toHash) {
         // For this example, I'm requiring size_t to be 64-bit, but you could
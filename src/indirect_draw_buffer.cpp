@@ -0,0 +1,66 @@
+#include "indirect_draw_buffer.hpp"
+#include "gl_state_cache.hpp"
+#include <gsl/gsl>
+#include <utility>
+
+IndirectDrawBuffer::IndirectDrawBuffer() noexcept {
+    glCreateBuffers(1U, &mCommandBufferName);
+    glCreateBuffers(1U, &mMetadataBufferName);
+}
+
+IndirectDrawBuffer::IndirectDrawBuffer(IndirectDrawBuffer&& other) noexcept {
+    using std::swap;
+    swap(mCommandBufferName, other.mCommandBufferName);
+    swap(mMetadataBufferName, other.mMetadataBufferName);
+    swap(mCurrentCommandBufferSize, other.mCurrentCommandBufferSize);
+    swap(mCurrentMetadataBufferSize, other.mCurrentMetadataBufferSize);
+}
+
+IndirectDrawBuffer::~IndirectDrawBuffer() {
+    GLStateCache::instance().onBufferDeleted(mCommandBufferName);
+    GLStateCache::instance().onBufferDeleted(mMetadataBufferName);
+    glDeleteBuffers(1U, &mCommandBufferName);
+    glDeleteBuffers(1U, &mMetadataBufferName);
+}
+
+IndirectDrawBuffer& IndirectDrawBuffer::operator=(IndirectDrawBuffer&& other) noexcept {
+    using std::swap;
+    swap(mCommandBufferName, other.mCommandBufferName);
+    swap(mMetadataBufferName, other.mMetadataBufferName);
+    swap(mCurrentCommandBufferSize, other.mCurrentCommandBufferSize);
+    swap(mCurrentMetadataBufferSize, other.mCurrentMetadataBufferSize);
+    return *this;
+}
+
+void IndirectDrawBuffer::submit(
+        std::span<DrawElementsIndirectCommand const> const commands,
+        std::span<DrawMetadata const> const metadata
+) noexcept {
+    upload(mCommandBufferName,
+           mCurrentCommandBufferSize,
+           commands.data(),
+           gsl::narrow_cast<GLsizeiptr>(commands.size_bytes()));
+    upload(mMetadataBufferName,
+           mCurrentMetadataBufferSize,
+           metadata.data(),
+           gsl::narrow_cast<GLsizeiptr>(metadata.size_bytes()));
+}
+
+void IndirectDrawBuffer::bind(GLuint const metadataBindingPoint) const noexcept {
+    GLStateCache::instance().bindBuffer(GL_DRAW_INDIRECT_BUFFER, mCommandBufferName);
+    GLStateCache::instance().bindBufferBase(GL_SHADER_STORAGE_BUFFER, metadataBindingPoint, mMetadataBufferName);
+}
+
+void IndirectDrawBuffer::upload(
+        GLuint const bufferName,
+        GLsizeiptr& currentSize,
+        void const* const data,
+        GLsizeiptr const size
+) noexcept {
+    if (size > currentSize) {
+        glNamedBufferData(bufferName, size, data, GL_STREAM_DRAW);
+        currentSize = size;
+    } else {
+        glNamedBufferSubData(bufferName, 0, size, data);
+    }
+}
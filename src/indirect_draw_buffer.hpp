@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <span>
+
+// layout as expected by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 5 * sizeof(GLuint));
+
+// per-draw data that shaders can access via gl_BaseInstanceARB + gl_DrawIDARB (std430 layout)
+struct DrawMetadata {
+    GLuint firstVertex;
+    GLuint numVertices;
+    GLuint numTextures;
+    GLuint padding;
+};
+static_assert(sizeof(DrawMetadata) == 4 * sizeof(GLuint));
+
+class IndirectDrawBuffer final {
+public:
+    IndirectDrawBuffer() noexcept;
+    IndirectDrawBuffer(IndirectDrawBuffer const&) = delete;
+    IndirectDrawBuffer(IndirectDrawBuffer&& other) noexcept;
+    ~IndirectDrawBuffer();
+
+    IndirectDrawBuffer& operator=(IndirectDrawBuffer const&) = delete;
+    IndirectDrawBuffer& operator=(IndirectDrawBuffer&& other) noexcept;
+
+    void submit(std::span<DrawElementsIndirectCommand const> commands, std::span<DrawMetadata const> metadata) noexcept;
+    void bind(GLuint metadataBindingPoint) const noexcept;
+
+private:
+    static void upload(GLuint bufferName, GLsizeiptr& currentSize, void const* data, GLsizeiptr size) noexcept;
+
+private:
+    GLuint mCommandBufferName{ 0U };
+    GLuint mMetadataBufferName{ 0U };
+    GLsizeiptr mCurrentCommandBufferSize{ 0LL };
+    GLsizeiptr mCurrentMetadataBufferSize{ 0LL };
+};
@@ -1,30 +1,22 @@
 #include "input.hpp"
 #include <cassert>
 #include <gsl/gsl>
-#include <range/v3/all.hpp>
-
-Input::Input() noexcept {
-    ranges::fill(mKeyBuffer, false);
-    mPressedThisFrame.reserve(20);
-    mRepeatedThisFrame.reserve(20);
-    mReleasedThisFrame.reserve(20);
-    ranges::fill(mMouseButtonBuffer, false);
-}
+#include <spdlog/spdlog.h>
 
 bool Input::keyDown(Key key) const noexcept {
-    return mKeyBuffer[static_cast<std::size_t>(key)];
+    return mKeysDown[static_cast<std::size_t>(key)];
 }
 
 bool Input::keyPressed(Key key) const noexcept {
-    return ranges::contains(mPressedThisFrame, key);
+    return mKeysPressedThisFrame[static_cast<std::size_t>(key)];
 }
 
 bool Input::keyRepeated(Key key) const noexcept {
-    return ranges::contains(mRepeatedThisFrame, key);
+    return mKeysRepeatedThisFrame[static_cast<std::size_t>(key)];
 }
 
 bool Input::keyReleased(Key key) const noexcept {
-    return ranges::contains(mReleasedThisFrame, key);
+    return mKeysReleasedThisFrame[static_cast<std::size_t>(key)];
 }
 
 bool Input::mouseInsideWindow() const noexcept {
@@ -32,33 +24,34 @@ bool Input::mouseInsideWindow() const noexcept {
 }
 
 bool Input::mouseDown(MouseButton button) const noexcept {
-    return mMouseButtonBuffer[static_cast<std::size_t>(button)];
+    return mMouseButtonsDown[static_cast<std::size_t>(button)];
 }
 
 bool Input::mousePressed(MouseButton button) const noexcept {
-    return ranges::contains(mMouseButtonsPressedThisFrame, button);
+    return mMouseButtonsPressedThisFrame[static_cast<std::size_t>(button)];
 }
 
 bool Input::mouseReleased(MouseButton button) const noexcept {
-    return ranges::contains(mMouseButtonsReleasedThisFrame, button);
+    return mMouseButtonsReleasedThisFrame[static_cast<std::size_t>(button)];
 }
 
 void Input::keyCallback(int glfwKeyCode, int glfwAction) noexcept {
     // TODO: handle key modifiers
-    if (glfwKeyCode < 0) {
+    if (glfwKeyCode < 0 || static_cast<std::size_t>(glfwKeyCode) >= numKeys) {
         return;
     }
+    auto const key = static_cast<std::size_t>(glfwKeyCode);
     switch (glfwAction) {
         case GLFW_PRESS:
-            mKeyBuffer[static_cast<std::size_t>(glfwKeyCode)] = true;
-            mPressedThisFrame.push_back(static_cast<Key>(glfwKeyCode));
+            mKeysDown[key] = true;
+            mKeysPressedThisFrame[key] = true;
             break;
         case GLFW_RELEASE:
-            mKeyBuffer[static_cast<std::size_t>(glfwKeyCode)] = false;
-            mReleasedThisFrame.push_back(static_cast<Key>(glfwKeyCode));
+            mKeysDown[key] = false;
+            mKeysReleasedThisFrame[key] = true;
             break;
         case GLFW_REPEAT:
-            mRepeatedThisFrame.push_back(static_cast<Key>(glfwKeyCode));
+            mKeysRepeatedThisFrame[key] = true;
             break;
         default:
             assert(false && "invalid glfw action");
@@ -71,14 +64,18 @@ void Input::mouseCallback(double mouseX, double mouseY) noexcept {
 }
 
 void Input::mouseButtonCallback(int glfwButton, int glfwAction) noexcept {
+    if (glfwButton < 0 || static_cast<std::size_t>(glfwButton) >= numMouseButtons) {
+        return;
+    }
+    auto const button = static_cast<std::size_t>(glfwButton);
     switch (glfwAction) {
         case GLFW_PRESS:
-            mMouseButtonBuffer[glfwButton] = true;
-            mMouseButtonsPressedThisFrame.push_back(static_cast<MouseButton>(glfwButton));
+            mMouseButtonsDown[button] = true;
+            mMouseButtonsPressedThisFrame[button] = true;
             break;
         case GLFW_RELEASE:
-            mMouseButtonBuffer[glfwButton] = false;
-            mMouseButtonsReleasedThisFrame.push_back(static_cast<MouseButton>(glfwButton));
+            mMouseButtonsDown[button] = false;
+            mMouseButtonsReleasedThisFrame[button] = true;
             break;
         default:
             assert(false && "invalid glfw action");
@@ -86,10 +83,51 @@ void Input::mouseButtonCallback(int glfwButton, int glfwAction) noexcept {
     }
 }
 
+void Input::deviceEvent(InputEvent const& event) noexcept {
+    if (mIsReplaying) {
+        return;
+    }
+    if (mRecording != nullptr) {
+        mRecording->record(event);
+    }
+    apply(event, glfwGetTime());
+}
+
+void Input::apply(InputEvent const& event, double const time) noexcept {
+    auto queuedEvent = TimestampedInputEvent{ .event{ event }, .time{ time } };
+    if (event.type == InputEvent::Type::MouseButton) {
+        queuedEvent.event.mouseX = mMousePosition.x;
+        queuedEvent.event.mouseY = mMousePosition.y;
+    }
+    if (!mEvents.push(queuedEvent)) {
+        ++mNumDroppedEvents;
+    }
+
+    switch (event.type) {
+        case InputEvent::Type::Key:
+            keyCallback(event.code, event.action);
+            break;
+        case InputEvent::Type::MouseMove:
+            mouseCallback(static_cast<double>(event.mouseX), static_cast<double>(event.mouseY));
+            break;
+        case InputEvent::Type::MouseEnterOrLeave:
+            mouseEnterOrLeaveCallback(event.action != 0);
+            break;
+        case InputEvent::Type::MouseButton:
+            mouseButtonCallback(event.code, event.action);
+            break;
+    }
+}
+
 void Input::nextFrame() noexcept {
-    mPressedThisFrame.clear();
-    mRepeatedThisFrame.clear();
-    mReleasedThisFrame.clear();
-    mMouseButtonsPressedThisFrame.clear();
-    mMouseButtonsReleasedThisFrame.clear();
+    mKeysPressedThisFrame.reset();
+    mKeysRepeatedThisFrame.reset();
+    mKeysReleasedThisFrame.reset();
+    mMouseButtonsPressedThisFrame.reset();
+    mMouseButtonsReleasedThisFrame.reset();
+    if (mNumDroppedEvents > 0) {
+        spdlog::warn("dropped {} input events of the last frame (event queue is full)", mNumDroppedEvents);
+        mNumDroppedEvents = 0;
+    }
+    mEvents.clear();
 }
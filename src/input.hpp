@@ -1,11 +1,12 @@
 #pragma once
 
+#include "input_recording.hpp"
+#include "ring_buffer.hpp"
 #include <GLFW/glfw3.h>
-#include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <glm/glm.hpp>
-#include <vector>
 
 enum class Key : std::size_t {
     // Unknown = GLFW_KEY_UNKNOWN,
@@ -149,9 +150,20 @@ enum class MouseButton : std::size_t {
     LastButton = Button8,
 };
 
+// An input event together with the time (glfwGetTime()) it was received at. Mouse button events carry the cursor
+// position at the time of the click: Input::apply() overwrites their mouseX/mouseY with the current cursor
+// position, also for replayed events (the values stored in a recording are ignored).
+struct TimestampedInputEvent {
+    InputEvent event;
+    double time;
+};
+
 class Input final {
 public:
-    Input() noexcept;
+    // High resolution mice and tablets report several hundred events per second, the oldest events of a frame are
+    // dropped if there are more.
+    static constexpr std::size_t eventQueueCapacity = 1024;
+    using EventQueue = RingBuffer<TimestampedInputEvent, eventQueueCapacity>;
 
     [[nodiscard]] bool keyDown(Key key) const noexcept;
     [[nodiscard]] bool keyPressed(Key key) const noexcept;
@@ -164,6 +176,10 @@ public:
     [[nodiscard]] bool mouseDown(MouseButton button) const noexcept;
     [[nodiscard]] bool mousePressed(MouseButton button) const noexcept;
     [[nodiscard]] bool mouseReleased(MouseButton button) const noexcept;
+    // all events since the last frame in the order they occurred
+    [[nodiscard]] EventQueue const& events() const noexcept {
+        return mEvents;
+    }
 
 private:
     enum class KeyState : uint8_t { Down, Up, Pressed, Released, Repeated };
@@ -177,18 +193,32 @@ private:
     void mouseButtonCallback(int glfwButton, int glfwAction) noexcept;
     void nextFrame() noexcept;
 
+    // Events coming from the window. They are recorded if a recording is set and dropped during a replay (the
+    // replayed events are passed to apply() instead).
+    void deviceEvent(InputEvent const& event) noexcept;
+    void apply(InputEvent const& event, double time) noexcept;
+
 private:
-    std::array<bool, static_cast<std::size_t>(Key::LastKey)> mKeyBuffer;
-    std::vector<Key> mPressedThisFrame;
-    std::vector<Key> mRepeatedThisFrame;
-    std::vector<Key> mReleasedThisFrame;
-
-    std::array<bool, static_cast<std::size_t>(MouseButton::LastButton)> mMouseButtonBuffer;
-    std::vector<MouseButton> mMouseButtonsPressedThisFrame;
-    std::vector<MouseButton> mMouseButtonsReleasedThisFrame;
+    static constexpr std::size_t numKeys = static_cast<std::size_t>(Key::LastKey) + 1;
+    static constexpr std::size_t numMouseButtons = static_cast<std::size_t>(MouseButton::LastButton) + 1;
+
+    std::bitset<numKeys> mKeysDown;
+    std::bitset<numKeys> mKeysPressedThisFrame;
+    std::bitset<numKeys> mKeysRepeatedThisFrame;
+    std::bitset<numKeys> mKeysReleasedThisFrame;
+
+    std::bitset<numMouseButtons> mMouseButtonsDown;
+    std::bitset<numMouseButtons> mMouseButtonsPressedThisFrame;
+    std::bitset<numMouseButtons> mMouseButtonsReleasedThisFrame;
     glm::vec2 mMousePosition{ 0.0f };
     bool mMouseInsideWindow{ false };
 
+    EventQueue mEvents;
+    std::size_t mNumDroppedEvents{ 0 };
+
+    InputRecording* mRecording{ nullptr };
+    bool mIsReplaying{ false };
+
     friend class Application;
 
     friend class Window;
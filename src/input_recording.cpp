@@ -0,0 +1,113 @@
+#include "input_recording.hpp"
+#include <cassert>
+#include <fstream>
+#include <gsl/gsl>
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr std::uint32_t fileMagic = 0x52'49'58'50; // "PXIR"
+    constexpr std::uint32_t fileVersion = 1;
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t randomSeed;
+        std::uint64_t numFrames;
+        std::uint64_t numEvents;
+    };
+} // namespace
+
+InputRecording::InputRecording(std::uint64_t const randomSeed) noexcept : mRandomSeed{ randomSeed } { }
+
+tl::expected<InputRecording, std::string> InputRecording::load(std::filesystem::path const& path) {
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (!file) {
+        return tl::unexpected{ fmt::format("unable to open input recording {}", path.string()) };
+    }
+    auto header = FileHeader{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != fileMagic || header.version != fileVersion) {
+        return tl::unexpected{ fmt::format("invalid input recording {}", path.string()) };
+    }
+    // check the sizes from the header against the file before allocating anything
+    auto fileSizeError = std::error_code{};
+    auto const fileSize = std::filesystem::file_size(path, fileSizeError);
+    if (fileSizeError || fileSize < sizeof(header)) {
+        return tl::unexpected{ fmt::format("unable to determine the size of input recording {}", path.string()) };
+    }
+    auto const numRemainingBytes = std::uint64_t{ fileSize - sizeof(header) };
+    if (header.numFrames > numRemainingBytes / sizeof(Frame)
+        || header.numEvents > (numRemainingBytes - header.numFrames * sizeof(Frame)) / sizeof(InputEvent)) {
+        return tl::unexpected{ fmt::format("truncated input recording {}", path.string()) };
+    }
+    auto result = InputRecording{ header.randomSeed };
+    result.mFrames.resize(gsl::narrow_cast<std::size_t>(header.numFrames));
+    result.mEvents.resize(gsl::narrow_cast<std::size_t>(header.numEvents));
+    file.read(
+            reinterpret_cast<char*>(result.mFrames.data()),
+            gsl::narrow_cast<std::streamsize>(result.mFrames.size() * sizeof(Frame))
+    );
+    file.read(
+            reinterpret_cast<char*>(result.mEvents.data()),
+            gsl::narrow_cast<std::streamsize>(result.mEvents.size() * sizeof(InputEvent))
+    );
+    if (!file) {
+        return tl::unexpected{ fmt::format("truncated input recording {}", path.string()) };
+    }
+    auto numReferencedEvents = std::uint64_t{ 0 };
+    for (auto const& frame : result.mFrames) {
+        numReferencedEvents += frame.numEvents;
+    }
+    if (numReferencedEvents != header.numEvents) {
+        return tl::unexpected{ fmt::format("inconsistent input recording {}", path.string()) };
+    }
+    result.mNumCommittedEvents = result.mEvents.size();
+    return result;
+}
+
+tl::expected<void, std::string> InputRecording::save(std::filesystem::path const& path) const {
+    auto const header = FileHeader{ .magic{ fileMagic },
+                                    .version{ fileVersion },
+                                    .randomSeed{ mRandomSeed },
+                                    .numFrames{ mFrames.size() },
+                                    .numEvents{ mNumCommittedEvents } };
+    auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(
+            reinterpret_cast<char const*>(mFrames.data()),
+            gsl::narrow_cast<std::streamsize>(mFrames.size() * sizeof(Frame))
+    );
+    // events of an uncommitted frame are left out
+    file.write(
+            reinterpret_cast<char const*>(mEvents.data()),
+            gsl::narrow_cast<std::streamsize>(mNumCommittedEvents * sizeof(InputEvent))
+    );
+    if (!file) {
+        return tl::unexpected{ fmt::format("unable to write input recording {}", path.string()) };
+    }
+    return {};
+}
+
+void InputRecording::record(InputEvent const& event) {
+    mEvents.push_back(event);
+}
+
+void InputRecording::commitFrame(double const delta) {
+    mFrames.push_back(Frame{ .delta{ delta },
+                             .numEvents{ gsl::narrow_cast<std::uint32_t>(mEvents.size() - mNumCommittedEvents) },
+                             .padding{ 0 } });
+    mNumCommittedEvents = mEvents.size();
+}
+
+InputReplay::InputReplay(InputRecording recording, std::optional<double> const fixedDelta) noexcept
+    : mRecording{ std::move(recording) },
+      mFixedDelta{ fixedDelta } { }
+
+InputReplay::ReplayedFrame InputReplay::nextFrame() noexcept {
+    assert(!isFinished() && "the replay is finished");
+    auto const& frame = mRecording.frames()[mNextFrame];
+    auto const events = mRecording.events().subspan(mNextEvent, frame.numEvents);
+    ++mNextFrame;
+    mNextEvent += frame.numEvents;
+    return ReplayedFrame{ .delta{ mFixedDelta.value_or(frame.delta) }, .events{ events } };
+}
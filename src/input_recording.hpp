@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <tl/expected.hpp>
+#include <type_traits>
+#include <vector>
+
+// an event as it is passed from the window to the Input callbacks
+struct InputEvent {
+    enum class Type : std::uint8_t {
+        Key,
+        MouseMove,
+        MouseEnterOrLeave,
+        MouseButton,
+    };
+
+    Type type;
+    // GLFW action for keys and mouse buttons, 1 (entered) or 0 (left) for MouseEnterOrLeave
+    std::uint8_t action;
+    std::uint16_t padding;
+    // GLFW key code or mouse button
+    std::int32_t code;
+    float mouseX;
+    float mouseY;
+
+    [[nodiscard]] static InputEvent key(int glfwKeyCode, int glfwAction) noexcept {
+        return InputEvent{ .type{ Type::Key },
+                           .action{ static_cast<std::uint8_t>(glfwAction) },
+                           .padding{ 0 },
+                           .code{ glfwKeyCode },
+                           .mouseX{ 0.0f },
+                           .mouseY{ 0.0f } };
+    }
+    [[nodiscard]] static InputEvent mouseMove(float mouseX, float mouseY) noexcept {
+        return InputEvent{ .type{ Type::MouseMove },
+                           .action{ 0 },
+                           .padding{ 0 },
+                           .code{ 0 },
+                           .mouseX{ mouseX },
+                           .mouseY{ mouseY } };
+    }
+    [[nodiscard]] static InputEvent mouseEnterOrLeave(bool entered) noexcept {
+        return InputEvent{ .type{ Type::MouseEnterOrLeave },
+                           .action{ static_cast<std::uint8_t>(entered ? 1 : 0) },
+                           .padding{ 0 },
+                           .code{ 0 },
+                           .mouseX{ 0.0f },
+                           .mouseY{ 0.0f } };
+    }
+    [[nodiscard]] static InputEvent mouseButton(int glfwButton, int glfwAction) noexcept {
+        return InputEvent{ .type{ Type::MouseButton },
+                           .action{ static_cast<std::uint8_t>(glfwAction) },
+                           .padding{ 0 },
+                           .code{ glfwButton },
+                           .mouseX{ 0.0f },
+                           .mouseY{ 0.0f } };
+    }
+};
+static_assert(std::is_trivially_copyable_v<InputEvent>);
+static_assert(sizeof(InputEvent) == 16);
+
+// The input events and frame time deltas of a run, together with the seed of the application's random number
+// generator. Replaying a recording with a fixed frame count reproduces the same workload (as long as the
+// application only depends on Input, Time and Random). Stored as a binary file in native byte order.
+class InputRecording final {
+public:
+    struct Frame {
+        // the events become visible to the frame that runs with this delta
+        double delta;
+        std::uint32_t numEvents;
+        std::uint32_t padding;
+    };
+    static_assert(std::is_trivially_copyable_v<Frame>);
+
+public:
+    explicit InputRecording(std::uint64_t randomSeed) noexcept;
+
+    [[nodiscard]] static tl::expected<InputRecording, std::string> load(std::filesystem::path const& path);
+    [[nodiscard]] tl::expected<void, std::string> save(std::filesystem::path const& path) const;
+
+    // events are collected until the frame is committed
+    void record(InputEvent const& event);
+    void commitFrame(double delta);
+
+    [[nodiscard]] std::uint64_t randomSeed() const noexcept {
+        return mRandomSeed;
+    }
+    [[nodiscard]] std::size_t numFrames() const noexcept {
+        return mFrames.size();
+    }
+    [[nodiscard]] std::span<Frame const> frames() const noexcept {
+        return mFrames;
+    }
+    [[nodiscard]] std::span<InputEvent const> events() const noexcept {
+        return mEvents;
+    }
+
+private:
+    std::uint64_t mRandomSeed;
+    std::vector<Frame> mFrames;
+    std::vector<InputEvent> mEvents;
+    std::size_t mNumCommittedEvents{ 0 };
+};
+
+// steps through a recording frame by frame
+class InputReplay final {
+public:
+    struct ReplayedFrame {
+        double delta;
+        std::span<InputEvent const> events;
+    };
+
+public:
+    // uses the recorded deltas if fixedDelta is not set
+    explicit InputReplay(InputRecording recording, std::optional<double> fixedDelta = std::nullopt) noexcept;
+
+    [[nodiscard]] bool isFinished() const noexcept {
+        return mNextFrame >= mRecording.numFrames();
+    }
+    [[nodiscard]] InputRecording const& recording() const noexcept {
+        return mRecording;
+    }
+    // must not be called when finished
+    [[nodiscard]] ReplayedFrame nextFrame() noexcept;
+
+private:
+    InputRecording mRecording;
+    std::optional<double> mFixedDelta;
+    std::size_t mNextFrame{ 0 };
+    std::size_t mNextEvent{ 0 };
+};
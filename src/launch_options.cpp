@@ -0,0 +1,74 @@
+#include "launch_options.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <string_view>
+
+namespace {
+    template<typename T>
+    [[nodiscard]] std::optional<T> readEnvironmentVariable(char const* const name) noexcept {
+        auto const variable = std::getenv(name);
+        if (variable == nullptr) {
+            return std::nullopt;
+        }
+        auto const text = std::string_view{ variable };
+        auto value = T{};
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            spdlog::warn("ignoring invalid value '{}' of {}", text, name);
+            return std::nullopt;
+        }
+        return value;
+    }
+} // namespace
+
+LaunchOptions LaunchOptions::fromEnvironment() noexcept {
+    auto result = LaunchOptions{};
+    if (readEnvironmentVariable<int>("PIXELATOR_HEADLESS").value_or(0) != 0) {
+        result.windowMode = WindowMode::Headless;
+    }
+    result.frameCount = readEnvironmentVariable<std::uint64_t>("PIXELATOR_FRAME_COUNT");
+    result.duration = readEnvironmentVariable<double>("PIXELATOR_DURATION");
+    result.simulationStepsPerFrame = readEnvironmentVariable<std::uint32_t>("PIXELATOR_SIMULATION_STEPS_PER_FRAME");
+    if (auto const pacing = std::getenv("PIXELATOR_PACING"); pacing != nullptr) {
+        result.framePacing = FramePacingSettings::parse(pacing);
+        if (!result.framePacing) {
+            spdlog::warn("ignoring invalid value '{}' of PIXELATOR_PACING", pacing);
+        }
+    }
+    if (auto const firstFrame = readEnvironmentVariable<std::uint64_t>("PIXELATOR_TRACE_FIRST_FRAME")) {
+        result.traceFrames = TraceFrameRange{
+            .firstFrame{ *firstFrame },
+            .numFrames{ readEnvironmentVariable<std::uint64_t>("PIXELATOR_TRACE_FRAME_COUNT").value_or(1) },
+        };
+    }
+    if (auto const recordFile = std::getenv("PIXELATOR_RECORD_INPUT"); recordFile != nullptr) {
+        result.recordInputFile = recordFile;
+    }
+    if (auto const replayFile = std::getenv("PIXELATOR_REPLAY_INPUT"); replayFile != nullptr) {
+        result.replayInputFile = replayFile;
+        result.replayDelta = readEnvironmentVariable<double>("PIXELATOR_REPLAY_DELTA");
+    }
+    if (auto const allocationCheck = std::getenv("PIXELATOR_ALLOCATION_CHECK"); allocationCheck != nullptr) {
+        if (auto const policy = parseAllocationPolicy(allocationCheck)) {
+            result.steadyStateAllocationPolicy = *policy;
+        } else {
+            spdlog::warn("ignoring invalid value '{}' of PIXELATOR_ALLOCATION_CHECK", allocationCheck);
+        }
+        if (!AllocationTracker::isEnabled()) {
+            spdlog::warn("PIXELATOR_ALLOCATION_CHECK has no effect without ENABLE_ALLOCATION_TRACKING");
+        }
+    }
+    result.firstSteadyStateFrame = readEnvironmentVariable<std::uint64_t>("PIXELATOR_STEADY_STATE_FRAME")
+                                           .value_or(defaultFirstSteadyStateFrame);
+    result.useRenderThread = readEnvironmentVariable<int>("PIXELATOR_RENDER_THREAD").value_or(0) != 0;
+    // a replay ends with the recording
+    if (result.windowMode == WindowMode::Headless && !result.replayInputFile && !result.frameCount && !result.duration) {
+        result.frameCount = defaultHeadlessFrameCount;
+    }
+    return result;
+}
+
+bool LaunchOptions::isFinished(std::uint64_t const numFramesRendered, double const elapsedTime) const noexcept {
+    return (frameCount && numFramesRendered >= *frameCount) || (duration && elapsedTime >= *duration);
+}
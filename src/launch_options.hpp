@@ -0,0 +1,53 @@
+#pragma once
+
+#include "allocation_tracker.hpp"
+#include "frame_pacer.hpp"
+#include "trace_capture.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+enum class WindowMode {
+    Windowed,
+    // no display required: the context is created via EGL (surfaceless) or OSMesa and everything is rendered into an
+    // offscreen target
+    Headless,
+};
+
+// Determines how an Application is run. Read from the environment so that the same executable can be used
+// interactively, on render nodes and in benchmarks:
+//   PIXELATOR_HEADLESS=1          create an offscreen context instead of a window
+//   PIXELATOR_FRAME_COUNT=<n>     quit after n frames
+//   PIXELATOR_DURATION=<seconds>  quit after the given time has elapsed
+//   PIXELATOR_SIMULATION_STEPS_PER_FRAME=<n>  run n fixed simulation steps per frame (batch mode)
+//   PIXELATOR_PACING=<mode>       "unlimited", "vsync", "on-demand" or a target frame rate (e.g. "60")
+//   PIXELATOR_TRACE_FIRST_FRAME=<n>, PIXELATOR_TRACE_FRAME_COUNT=<n>  capture a trace of the given frames
+//   PIXELATOR_RECORD_INPUT=<file> write the input events and frame deltas to the given file when quitting
+//   PIXELATOR_REPLAY_INPUT=<file> replay a recording instead of using the input of the window (quits at its end)
+//   PIXELATOR_REPLAY_DELTA=<seconds>  replay with a fixed frame delta instead of the recorded ones
+//   PIXELATOR_ALLOCATION_CHECK=<policy>  "warn" or "assert" when a steady state frame allocates on the main thread
+//                                 (requires ENABLE_ALLOCATION_TRACKING)
+//   PIXELATOR_STEADY_STATE_FRAME=<n>  first frame that counts as steady state
+//   PIXELATOR_RENDER_THREAD=1     submit the frames to OpenGL on a separate render thread
+struct LaunchOptions {
+    // headless runs without an explicit limit stop after this many frames
+    static constexpr std::uint64_t defaultHeadlessFrameCount = 600;
+    // the first frames are expected to allocate (lazily created resources, growing buffers)
+    static constexpr std::uint64_t defaultFirstSteadyStateFrame = 60;
+
+    WindowMode windowMode{ WindowMode::Windowed };
+    std::optional<std::uint64_t> frameCount;
+    std::optional<double> duration;
+    std::optional<std::uint32_t> simulationStepsPerFrame;
+    std::optional<FramePacingSettings> framePacing;
+    std::optional<TraceFrameRange> traceFrames;
+    std::optional<std::filesystem::path> recordInputFile;
+    std::optional<std::filesystem::path> replayInputFile;
+    std::optional<double> replayDelta;
+    AllocationPolicy steadyStateAllocationPolicy{ AllocationPolicy::Ignore };
+    std::uint64_t firstSteadyStateFrame{ defaultFirstSteadyStateFrame };
+    bool useRenderThread{ false };
+
+    [[nodiscard]] static LaunchOptions fromEnvironment() noexcept;
+    [[nodiscard]] bool isFinished(std::uint64_t numFramesRendered, double elapsedTime) const noexcept;
+};
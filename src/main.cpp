@@ -1,93 +1,114 @@
 #include "application.hpp"
+#include "canvas_kernel.hpp"
 #include "include_glm.hpp"
 #include "input.hpp"
+#include "stroke.hpp"
 #include "window.hpp"
 #include <array>
+#include <cstdlib>
 #include <glm/ext/vector_common.hpp>
+#include <string_view>
+#include <utility>
 
 class TestApplication final : public Application {
 private:
     glm::ivec2 m_resolution;
-    std::vector<unsigned char> m_buffer;
+    CanvasBackend m_backend;
+    std::unique_ptr<CanvasKernel> m_canvas;
     ShaderProgram m_shader_program{ ShaderProgram::defaultProgram() };
-    Texture m_texture;
+    Stroke m_stroke{ MouseButton::Left };
 
 public:
-    explicit TestApplication(glm::ivec2 const resolution)
+    TestApplication(glm::ivec2 const resolution, CanvasBackend const backend)
         : m_resolution{ resolution },
-          m_buffer(resolution.x * resolution.y * 4, 0) { }
+          m_backend{ backend } { }
 
 private:
-    void setup() noexcept override { }
+    void setup() noexcept override {
+        auto canvas = createDiffusionKernel(m_backend, m_resolution);
+        if (!canvas && m_backend != CanvasBackend::Cpu) {
+            spdlog::error("Falling back to the CPU canvas backend: {}", canvas.error());
+            canvas = createDiffusionKernel(CanvasBackend::Cpu, m_resolution);
+        }
+        m_canvas = std::move(canvas.value());
+        // one virtual pixel per canvas cell, upscaled to the window afterwards
+        mRenderer.setVirtualResolution(m_resolution);
+    }
 
-    void update() noexcept override {
+    void fixedUpdate() noexcept override {
         auto const center = glm::vec2{ m_resolution.x / 2, m_resolution.y / 2 };
-        auto const radius_offset_factor = static_cast<float>(std::sin(mTime.elapsed * 0.8)) * 0.3f + 1.0f;
+        auto const radius_offset_factor = static_cast<float>(std::sin(mTime.simulationElapsed * 0.8)) * 0.3f + 1.0f;
         auto const radius = static_cast<float>(std::min(m_resolution.x, m_resolution.y) * 0.2) * radius_offset_factor;
         auto const movement_speed = 6.0f;
         auto const point = glm::vec2{
-            center.x + radius * std::cos(mTime.elapsed * movement_speed),
-            center.y + radius * std::sin(mTime.elapsed * movement_speed),
+            center.x + radius * std::cos(mTime.simulationElapsed * movement_speed),
+            center.y + radius * std::sin(mTime.simulationElapsed * movement_speed),
         };
-        set_pixel(glm::ivec2{ static_cast<int>(point.x), static_cast<int>(point.y) }, Color::white());
+        auto const pixel = glm::ivec2{ static_cast<int>(point.x), static_cast<int>(point.y) };
+        auto const delta = static_cast<float>(mTime.fixedDelta);
+        run_on_canvas([this, pixel, delta] {
+            m_canvas->setPixel(pixel, Color::white());
+            m_canvas->step(delta);
+        });
+    }
 
-        auto new_buffer = std::vector<unsigned char>(m_buffer.size(), 0);
-        for (auto y = 1; y < m_resolution.y - 1; ++y) {
-            for (auto x = 1; x < m_resolution.x - 1; ++x) {
-                auto const position = glm::ivec2{ x, y };
-                auto color_sum = glm::vec4{ 0.0f };
-                for (auto v = y - 1; v <= y + 1; ++v) {
-                    for (auto u = x - 1; u <= x + 1; ++u) {
-                        color_sum += get_pixel(glm::ivec2{ u, v });
+    void update() noexcept override {
+        // paints with the left mouse button
+        m_stroke.update(
+                mInput,
+                [this](glm::vec2 const position) {
+                    return glm::ivec2{ glm::floor(mRenderer.toVirtualPosition(position)) };
+                },
+                [this](glm::ivec2 const pixel) {
+                    if (pixel.x >= 0 && pixel.y >= 0 && pixel.x < m_resolution.x && pixel.y < m_resolution.y) {
+                        run_on_canvas([this, pixel] { m_canvas->setPixel(pixel, Color::white()); });
                     }
                 }
-                auto const average_color = color_sum / 9.0f;
-                auto const frame_delta = static_cast<float>(mTime.delta);
-                auto const rate = 0.2f;
-                auto const smoothing = 1.0f - rate;
-                auto const lerped = mix(get_pixel(position), average_color, 1.0f - std::pow(smoothing, frame_delta));
-
-                auto const pixel_num = x + y * m_resolution.x;
-                new_buffer.at(4 * pixel_num + 0) = static_cast<unsigned char>(lerped.r * 255.0f);
-                new_buffer.at(4 * pixel_num + 1) = static_cast<unsigned char>(lerped.g * 255.0f);
-                new_buffer.at(4 * pixel_num + 2) = static_cast<unsigned char>(lerped.b * 255.0f);
-                new_buffer.at(4 * pixel_num + 3) = static_cast<unsigned char>(lerped.a * 255.0f);
-            }
+        );
+        if (usesRenderThread()) {
+            auto& frame = currentFrame();
+            frame.clearColor = Color{ 0.0f, 0.0f, 0.0f, 1.0f };
+            // texture() may upload the canvas, so the draw command is recorded on the render thread as well
+            frame.renderTasks.emplace_back([this, &frame] {
+                frame.commands.drawQuad(
+                        glm::vec3{ 0.0f },
+                        0.0f,
+                        glm::vec2{ 1.0f },
+                        m_shader_program,
+                        m_canvas->texture()
+                );
+            });
+            return;
         }
-        m_buffer = std::move(new_buffer);
-
-        m_texture = Texture::createFromMemory(m_resolution.x, m_resolution.y, 4, m_buffer.data()).value();
-        m_texture.setFiltering(Texture::Filtering::Nearest);
-        mRenderer.beginFrame(glm::mat4{ 1.0 });
+        mRenderer.beginFrame(glm::mat4{ 1.0 }, mTime);
         mRenderer.setClearColor(Color{ 0.0f, 0.0f, 0.0f, 1.0f });
         mRenderer.clear(true, true);
-        mRenderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, m_shader_program, m_texture);
+        mRenderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, m_shader_program, m_canvas->texture());
         mRenderer.endFrame();
     }
 
-    void set_pixel(glm::ivec2 const position, Color const color) {
-        auto const pixel_num = position.x + position.y * m_resolution.x;
-        m_buffer.at(4 * pixel_num + 0) = static_cast<unsigned char>(color.r * 255.0f);
-        m_buffer.at(4 * pixel_num + 1) = static_cast<unsigned char>(color.g * 255.0f);
-        m_buffer.at(4 * pixel_num + 2) = static_cast<unsigned char>(color.b * 255.0f);
-        m_buffer.at(4 * pixel_num + 3) = static_cast<unsigned char>(color.a * 255.0f);
-    }
-
-    Color get_pixel(glm::ivec2 const position) const {
-        auto const pixel_num = position.x + position.y * m_resolution.x;
-        return Color{
-            static_cast<float>(m_buffer.at(4 * pixel_num + 0)) / 255.0f,
-            static_cast<float>(m_buffer.at(4 * pixel_num + 1)) / 255.0f,
-            static_cast<float>(m_buffer.at(4 * pixel_num + 2)) / 255.0f,
-            static_cast<float>(m_buffer.at(4 * pixel_num + 3)) / 255.0f,
-        };
+    // The canvas kernels use OpenGL, so with PIXELATOR_RENDER_THREAD=1 the canvas belongs to the render thread and
+    // is only modified by the render tasks of the recorded frames.
+    template<typename Function>
+    void run_on_canvas(Function&& function) {
+        if (usesRenderThread()) {
+            currentFrame().renderTasks.emplace_back(std::forward<Function>(function));
+        } else {
+            function();
+        }
     }
 };
 
 int main() {
+    // PIXELATOR_CANVAS_BACKEND=compute runs the simulation in a compute shader
+    auto const backend_variable = std::getenv("PIXELATOR_CANVAS_BACKEND");
+    auto const backend = (backend_variable != nullptr && std::string_view{ backend_variable } == "compute")
+                                 ? CanvasBackend::Compute
+                                 : CanvasBackend::Cpu;
     auto application = TestApplication{
         //glm::ivec2{ 400, 300 }
-        glm::ivec2{ 100, 75 }
+        glm::ivec2{ 100, 75 },
+        backend
     };
     application.run();
 }
@@ -0,0 +1,99 @@
+#include "particle_system.hpp"
+#include "scoped_timer.hpp"
+#include "vertex_format.hpp"
+
+ParticleSystem::ParticleSystem(std::size_t const maxNumParticles)
+    : mPositionsX(maxNumParticles),
+      mPositionsY(maxNumParticles),
+      mVelocitiesX(maxNumParticles),
+      mVelocitiesY(maxNumParticles),
+      mRemainingLifetimes(maxNumParticles),
+      mInverseLifetimes(maxNumParticles),
+      mSizes(maxNumParticles),
+      mColors(maxNumParticles) { }
+
+bool ParticleSystem::emit(ParticleDescription const& particle) noexcept {
+    if (mNumParticles == capacity() || particle.lifetime <= 0.0f) {
+        return false;
+    }
+    auto const i = mNumParticles++;
+    mPositionsX[i] = particle.position.x;
+    mPositionsY[i] = particle.position.y;
+    mVelocitiesX[i] = particle.velocity.x;
+    mVelocitiesY[i] = particle.velocity.y;
+    mRemainingLifetimes[i] = particle.lifetime;
+    mInverseLifetimes[i] = 1.0f / particle.lifetime;
+    mSizes[i] = particle.size;
+    mColors[i] = detail::packColor(particle.color);
+    return true;
+}
+
+void ParticleSystem::update(float const deltaTime, glm::vec2 const gravity) noexcept {
+    SCOPED_TIMER();
+    auto const numParticles = mNumParticles;
+    // separate restrict pointers tell the compiler that the arrays don't alias, so the loop gets vectorized
+    float* __restrict const positionsX = mPositionsX.data();
+    float* __restrict const positionsY = mPositionsY.data();
+    float* __restrict const velocitiesX = mVelocitiesX.data();
+    float* __restrict const velocitiesY = mVelocitiesY.data();
+    float* __restrict const remainingLifetimes = mRemainingLifetimes.data();
+    auto const deltaVelocityX = gravity.x * deltaTime;
+    auto const deltaVelocityY = gravity.y * deltaTime;
+    for (std::size_t i = 0; i < numParticles; ++i) {
+        velocitiesX[i] += deltaVelocityX;
+        velocitiesY[i] += deltaVelocityY;
+        positionsX[i] += velocitiesX[i] * deltaTime;
+        positionsY[i] += velocitiesY[i] * deltaTime;
+        remainingLifetimes[i] -= deltaTime;
+    }
+    removeDeadParticles();
+}
+
+void ParticleSystem::clear() noexcept {
+    mNumParticles = 0;
+}
+
+void ParticleSystem::removeDeadParticles() noexcept {
+    // the order of the particles doesn't matter, so dead particles are replaced by the last living one
+    std::size_t i = 0;
+    while (i < mNumParticles) {
+        if (mRemainingLifetimes[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        auto const last = --mNumParticles;
+        mPositionsX[i] = mPositionsX[last];
+        mPositionsY[i] = mPositionsY[last];
+        mVelocitiesX[i] = mVelocitiesX[last];
+        mVelocitiesY[i] = mVelocitiesY[last];
+        mRemainingLifetimes[i] = mRemainingLifetimes[last];
+        mInverseLifetimes[i] = mInverseLifetimes[last];
+        mSizes[i] = mSizes[last];
+        mColors[i] = mColors[last];
+    }
+}
+
+void ParticleEmitter::update(float const deltaTime, ParticleSystem& particleSystem, Random& random) noexcept {
+    mPendingEmissions += mSettings.emissionRate * deltaTime;
+    auto const count = static_cast<std::size_t>(mPendingEmissions);
+    mPendingEmissions -= static_cast<float>(count);
+    burst(count, particleSystem, random);
+}
+
+void ParticleEmitter::burst(std::size_t const count, ParticleSystem& particleSystem, Random& random) noexcept {
+    auto const halfSpread = mSettings.spread * 0.5f;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const angle = mSettings.direction + random.range(-halfSpread, halfSpread);
+        auto const speed = random.range(mSettings.minSpeed, mSettings.maxSpeed);
+        auto const emitted = particleSystem.emit(ParticleDescription{
+                .position{ mSettings.position },
+                .velocity{ glm::vec2{ glm::cos(angle), glm::sin(angle) } * speed },
+                .lifetime{ random.range(mSettings.minLifetime, mSettings.maxLifetime) },
+                .size{ random.range(mSettings.minSize, mSettings.maxSize) },
+                .color{ mSettings.color },
+        });
+        if (!emitted) {
+            break;
+        }
+    }
+}
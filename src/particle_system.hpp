@@ -0,0 +1,122 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "color.hpp"
+#include "include_glm.hpp"
+#include "random.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+
+struct ParticleDescription {
+    glm::vec2 position;
+    glm::vec2 velocity;
+    float lifetime;
+    float size;
+    Color color;
+};
+
+// Stores every particle attribute in its own cache line aligned array (structure of arrays), so that the
+// simulation loops only touch the data they need and can be auto-vectorized by the compiler.
+class ParticleSystem final {
+public:
+    explicit ParticleSystem(std::size_t maxNumParticles);
+
+    // returns false if the system is full
+    bool emit(ParticleDescription const& particle) noexcept;
+    // integrates the motion of all particles and removes the ones whose lifetime is over
+    void update(float deltaTime, glm::vec2 gravity = glm::vec2{ 0.0f }) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mNumParticles;
+    }
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return mPositionsX.size();
+    }
+
+    // Writes one quad (four vertices) per particle in [first, first + count) that fades out over its lifetime.
+    template<typename Vertex>
+    void writeQuadVertices(Vertex* vertices, std::size_t first, std::size_t count, GLuint texIndex) const noexcept;
+
+private:
+    void removeDeadParticles() noexcept;
+
+private:
+    std::size_t mNumParticles{ 0 };
+    AlignedVector<float> mPositionsX;
+    AlignedVector<float> mPositionsY;
+    AlignedVector<float> mVelocitiesX;
+    AlignedVector<float> mVelocitiesY;
+    AlignedVector<float> mRemainingLifetimes;
+    AlignedVector<float> mInverseLifetimes;
+    AlignedVector<float> mSizes;
+    AlignedVector<glm::u8vec4> mColors;
+};
+
+struct ParticleEmitterSettings {
+    glm::vec2 position{ 0.0f };
+    // direction (in radians) and angular spread of the initial velocity
+    float direction{ 0.0f };
+    float spread{ 2.0f * glm::pi<float>() };
+    float minSpeed{ 0.1f };
+    float maxSpeed{ 0.5f };
+    float minLifetime{ 0.5f };
+    float maxLifetime{ 1.5f };
+    float minSize{ 0.005f };
+    float maxSize{ 0.01f };
+    Color color{ Color::white() };
+    // particles per second
+    float emissionRate{ 1000.0f };
+};
+
+class ParticleEmitter final {
+public:
+    explicit ParticleEmitter(ParticleEmitterSettings const& settings) noexcept : mSettings{ settings } { }
+
+    // emits the particles that are due since the last update
+    void update(float deltaTime, ParticleSystem& particleSystem, Random& random) noexcept;
+    void burst(std::size_t count, ParticleSystem& particleSystem, Random& random) noexcept;
+
+    [[nodiscard]] ParticleEmitterSettings& settings() noexcept {
+        return mSettings;
+    }
+
+private:
+    ParticleEmitterSettings mSettings;
+    float mPendingEmissions{ 0.0f };
+};
+
+template<typename Vertex>
+void ParticleSystem::writeQuadVertices(
+        Vertex* const vertices,
+        std::size_t const first,
+        std::size_t const count,
+        GLuint const texIndex
+) const noexcept {
+    constexpr std::array<glm::vec2, 4> corners{
+        glm::vec2{ -1.0f, -1.0f },
+        glm::vec2{  1.0f, -1.0f },
+        glm::vec2{  1.0f,  1.0f },
+        glm::vec2{ -1.0f,  1.0f }
+    };
+    Vertex prototypes[4]{};
+    for (std::size_t corner = 0; corner < 4; ++corner) {
+        prototypes[corner].setTexCoords((corners[corner] + glm::vec2{ 1.0f }) * 0.5f);
+        prototypes[corner].setTexIndex(texIndex);
+    }
+    for (std::size_t i = first; i < first + count; ++i) {
+        auto color = mColors[i];
+        auto const fade = mRemainingLifetimes[i] * mInverseLifetimes[i];
+        color.a = static_cast<std::uint8_t>(static_cast<float>(color.a) * fade);
+        auto const quad = vertices + (i - first) * 4;
+        for (std::size_t corner = 0; corner < 4; ++corner) {
+            quad[corner] = prototypes[corner];
+            quad[corner].setPosition(glm::vec3{ mPositionsX[i] + corners[corner].x * mSizes[i],
+                                                mPositionsY[i] + corners[corner].y * mSizes[i],
+                                                0.0f });
+            quad[corner].setPackedColor(color);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include "program_binary_cache.hpp"
+#include <array>
+#include <fstream>
+#include <gsl/gsl>
+#include <spdlog/spdlog.h>
+#include <system_error>
+#include <vector>
+
+namespace {
+    constexpr std::uint32_t fileMagic = 0x50'4B'32'43; // "C2KP"
+    constexpr std::uint32_t fileVersion = 1;
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        GLenum binaryFormat;
+        std::uint32_t binarySize;
+    };
+
+    // FNV-1a, with every string terminated by a zero byte to keep "ab" + "c" and "a" + "bc" apart
+    [[nodiscard]] std::uint64_t hashCombine(std::uint64_t hash, std::string_view const data) noexcept {
+        for (auto const c : data) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash * 1099511628211ULL;
+    }
+
+    [[nodiscard]] std::string_view glString(GLenum const name) noexcept {
+        auto const result = glGetString(name);
+        if (result == nullptr) {
+            return {};
+        }
+        return reinterpret_cast<char const*>(result);
+    }
+} // namespace
+
+void ProgramBinaryCache::setDirectory(std::filesystem::path directory) {
+    sDirectory = std::move(directory);
+}
+
+std::filesystem::path const& ProgramBinaryCache::directory() noexcept {
+    if (sDirectory.empty()) {
+        auto errorCode = std::error_code{};
+        sDirectory = std::filesystem::temp_directory_path(errorCode) / "c2k_pixelator_shader_cache";
+    }
+    return sDirectory;
+}
+
+void ProgramBinaryCache::setEnabled(bool const enabled) noexcept {
+    sEnabled = enabled;
+}
+
+bool ProgramBinaryCache::isAvailable() noexcept {
+    if (!sEnabled) {
+        return false;
+    }
+    static bool const driverSupportsBinaries = [] {
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        if (numFormats == 0) {
+            spdlog::info("The driver does not support program binaries, shader programs will not be cached.");
+        }
+        return numFormats > 0;
+    }();
+    return driverSupportsBinaries;
+}
+
+std::uint64_t ProgramBinaryCache::key(std::initializer_list<std::string_view> const sources) noexcept {
+    auto result = std::uint64_t{ 0xcbf29ce484222325ULL };
+    result = hashCombine(result, glString(GL_RENDERER));
+    result = hashCombine(result, glString(GL_VERSION));
+    for (auto const source : sources) {
+        result = hashCombine(result, source);
+    }
+    return result;
+}
+
+tl::expected<GLuint, std::string> ProgramBinaryCache::load(std::uint64_t const key) noexcept {
+    if (!isAvailable()) {
+        return tl::unexpected{ std::string{ "program binary cache not available" } };
+    }
+    auto const path = filename(key);
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (!file) {
+        return tl::unexpected{ fmt::format("no cache entry {}", path.string()) };
+    }
+    auto header = FileHeader{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != fileMagic || header.version != fileVersion) {
+        return tl::unexpected{ fmt::format("invalid cache entry {}", path.string()) };
+    }
+    // a size that does not match the file is a corrupt entry and must not be allocated, the program gets recompiled
+    auto errorCode = std::error_code{};
+    auto const fileSize = std::filesystem::file_size(path, errorCode);
+    if (errorCode || fileSize != sizeof(header) + std::uintmax_t{ header.binarySize }) {
+        return tl::unexpected{ fmt::format("cache entry {} has an invalid size", path.string()) };
+    }
+    auto binary = std::vector<char>(header.binarySize);
+    file.read(binary.data(), gsl::narrow_cast<std::streamsize>(binary.size()));
+    if (!file) {
+        return tl::unexpected{ fmt::format("truncated cache entry {}", path.string()) };
+    }
+
+    auto const programName = glCreateProgram();
+    glProgramBinary(programName, header.binaryFormat, binary.data(), gsl::narrow_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(programName, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE) {
+        // the driver rejects binaries of other driver builds, they will be replaced after recompiling
+        glDeleteProgram(programName);
+        std::filesystem::remove(path, errorCode);
+        return tl::unexpected{ fmt::format("driver rejected cache entry {}", path.string()) };
+    }
+    return programName;
+}
+
+void ProgramBinaryCache::store(std::uint64_t const key, GLuint const programName) noexcept {
+    if (!isAvailable()) {
+        return;
+    }
+    GLint binarySize = 0;
+    glGetProgramiv(programName, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0) {
+        return;
+    }
+    auto header = FileHeader{ .magic{ fileMagic },
+                              .version{ fileVersion },
+                              .binaryFormat{ GL_NONE },
+                              .binarySize{ static_cast<std::uint32_t>(binarySize) } };
+    auto binary = std::vector<char>(header.binarySize);
+    glGetProgramBinary(programName, binarySize, nullptr, &header.binaryFormat, binary.data());
+
+    auto errorCode = std::error_code{};
+    std::filesystem::create_directories(directory(), errorCode);
+    if (errorCode) {
+        spdlog::warn("Could not create shader cache directory {}: {}", directory().string(), errorCode.message());
+        return;
+    }
+    // write to a temporary file first so that other instances never read a partially written entry
+    auto const path = filename(key);
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        auto file = std::ofstream{ temporaryPath, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(binary.data(), gsl::narrow_cast<std::streamsize>(binary.size()));
+        if (!file) {
+            spdlog::warn("Could not write shader cache entry {}", temporaryPath.string());
+            return;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryPath, errorCode);
+    }
+}
+
+std::filesystem::path ProgramBinaryCache::filename(std::uint64_t const key) {
+    return directory() / fmt::format("{:016x}.bin", key);
+}
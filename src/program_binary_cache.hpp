@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <glad/gl.h>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <tl/expected.hpp>
+
+// Stores linked shader programs as driver-specific binaries (glGetProgramBinary) on disk, so that later runs
+// can skip compiling and linking. Entries are keyed by the shader sources as well as the GL renderer and
+// driver version, because binaries are not portable across drivers or driver updates.
+class ProgramBinaryCache final {
+public:
+    ProgramBinaryCache() = delete;
+
+    static void setDirectory(std::filesystem::path directory);
+    [[nodiscard]] static std::filesystem::path const& directory() noexcept;
+    static void setEnabled(bool enabled) noexcept;
+    // false if disabled or if the driver doesn't support any program binary formats
+    [[nodiscard]] static bool isAvailable() noexcept;
+
+    [[nodiscard]] static std::uint64_t key(std::initializer_list<std::string_view> sources) noexcept;
+    // creates a new linked program on success
+    [[nodiscard]] static tl::expected<GLuint, std::string> load(std::uint64_t key) noexcept;
+    // the program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+    static void store(std::uint64_t key, GLuint programName) noexcept;
+
+private:
+    [[nodiscard]] static std::filesystem::path filename(std::uint64_t key);
+
+private:
+    static inline bool sEnabled{ true };
+    static inline std::filesystem::path sDirectory{};
+};
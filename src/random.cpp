@@ -1,3 +1,80 @@
 #include "random.hpp"
+#include "hash/hash.hpp"
+#include <random>
 
-Random::Random() noexcept : mRandomEngine{ mRandomDevice() } { }
+namespace {
+    [[nodiscard]] std::uint64_t nonDeterministicSeed() noexcept {
+        auto randomDevice = std::random_device{};
+        return (static_cast<std::uint64_t>(randomDevice()) << 32U) ^ static_cast<std::uint64_t>(randomDevice());
+    }
+} // namespace
+
+Random::Random() noexcept : Random{ nonDeterministicSeed() } { }
+
+// The bulk lanes start one, two, three and four long jumps (2^192 steps each) away from the scalar stream.
+Random::Random(std::uint64_t const seed) noexcept
+    : mEngine{ seed },
+      mBulkEngine{ [this] {
+          auto source = mEngine;
+          source.longJump();
+          return Xoshiro256StarStarX4{ source };
+      }() },
+      mSeed{ seed } { }
+
+void Random::seed(std::uint64_t const seed) noexcept {
+    *this = Random{ seed };
+}
+
+Random Random::split() noexcept {
+    // Jumping the engine would give the child the streams that this generator uses after its next split, and a
+    // child splitting again would end up with the streams of its parent. Seeds derived from the path of splits
+    // (seed of the parent, index of the child) don't have this problem.
+    ++mNumSplits;
+    return Random{ hash::hash128To64(mSeed, mNumSplits) };
+}
+
+template<typename Function>
+void Random::fillBulk(std::size_t const count, Function&& store) noexcept {
+    auto bits = std::array<std::uint64_t, Xoshiro256StarStarX4::numLanes>{};
+    std::size_t i = 0;
+    for (; i + bits.size() <= count; i += bits.size()) {
+        mBulkEngine(bits);
+        for (std::size_t lane = 0; lane < bits.size(); ++lane) {
+            store(i + lane, bits[lane]);
+        }
+    }
+    if (i < count) {
+        mBulkEngine(bits);
+        for (std::size_t lane = 0; i + lane < count; ++lane) {
+            store(i + lane, bits[lane]);
+        }
+    }
+}
+
+void Random::fill(std::span<float> const values, float const minInclusive, float const maxExclusive) noexcept {
+    auto const scale = maxExclusive - minInclusive;
+    fillBulk(values.size(), [&](std::size_t const i, std::uint64_t const bits) {
+        values[i] = minInclusive + detail::unitInterval<float>(bits) * scale;
+    });
+}
+
+void Random::fill(std::span<std::uint32_t> const values) noexcept {
+    fillBulk(values.size(), [&](std::size_t const i, std::uint64_t const bits) {
+        values[i] = static_cast<std::uint32_t>(bits >> 32U);
+    });
+}
+
+void Random::fill(std::span<std::uint64_t> const values) noexcept {
+    fillBulk(values.size(), [&](std::size_t const i, std::uint64_t const bits) { values[i] = bits; });
+}
+
+void Random::fill(
+        std::span<std::uint32_t> const values,
+        std::uint32_t const minInclusive,
+        std::uint32_t const maxInclusive
+) noexcept {
+    auto const range = static_cast<std::uint64_t>(maxInclusive - minInclusive) + 1U;
+    fillBulk(values.size(), [&](std::size_t const i, std::uint64_t const bits) {
+        values[i] = minInclusive + static_cast<std::uint32_t>(((bits >> 32U) * range) >> 32U);
+    });
+}
@@ -1,26 +1,93 @@
 #pragma once
 
-
-#pragma once
-
 #include "include_glm.hpp"
+#include "xoshiro256.hpp"
+#include <array>
+#include <concepts>
+#include <cstdint>
 #include <limits>
-#include <random>
+#include <span>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace detail {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 UInt128;
+#endif
+
+    // returns the lower 64 bits of the 128 bit product, the upper 64 bits are stored in high
+    [[nodiscard]] inline std::uint64_t
+    multiply64(std::uint64_t const lhs, std::uint64_t const rhs, std::uint64_t& high) noexcept {
+#if defined(__SIZEOF_INT128__)
+        auto const product = static_cast<UInt128>(lhs) * rhs;
+        high = static_cast<std::uint64_t>(product >> 64U);
+        return static_cast<std::uint64_t>(product);
+#else
+        return _umul128(lhs, rhs, &high);
+#endif
+    }
+
+    // maps 64 random bits to [0, range) without modulo bias (Lemire, "Fast Random Integer Generation in an Interval")
+    template<typename Engine>
+    [[nodiscard]] std::uint64_t boundedRandom(Engine& engine, std::uint64_t const range) noexcept {
+        auto high = std::uint64_t{};
+        auto low = multiply64(engine(), range, high);
+        if (low < range) {
+            auto const threshold = (0U - range) % range;
+            while (low < threshold) {
+                low = multiply64(engine(), range, high);
+            }
+        }
+        return high;
+    }
+
+    template<std::floating_point T>
+    [[nodiscard]] constexpr T unitInterval(std::uint64_t const bits) noexcept {
+        // the upper bits are used because they have the best quality
+        if constexpr (std::is_same_v<T, float>) {
+            return static_cast<float>(bits >> 40U) * 0x1.0p-24f;
+        } else {
+            return static_cast<T>(static_cast<double>(bits >> 11U) * 0x1.0p-53);
+        }
+    }
+} // namespace detail
 
 class Random {
 public:
+    using Engine = Xoshiro256StarStar;
+
+public:
+    // seeded non-deterministically
     Random() noexcept;
+    explicit Random(std::uint64_t seed) noexcept;
+
+    void seed(std::uint64_t seed) noexcept;
+    // Returns a generator with its own stream (e.g. for a worker thread), deterministic for a given seed and number
+    // of previous splits. The child is seeded from the seed of this generator and its split counter, so generators
+    // split off children (or grandchildren) never share their state. Their streams start at unrelated positions of
+    // the 2^256 period, an overlap is practically impossible.
+    [[nodiscard]] Random split() noexcept;
 
     template<std::integral T>
     [[nodiscard]] T range(T minInclusive, T maxInclusive) noexcept {
-        std::uniform_int_distribution<T> distribution{ minInclusive, maxInclusive };
-        return distribution(mRandomEngine);
+        using Unsigned = std::make_unsigned_t<T>;
+        // the difference is computed unsigned, in T it overflows for spans wider than half the range of T
+        auto const span = static_cast<std::uint64_t>(
+                static_cast<Unsigned>(static_cast<Unsigned>(maxInclusive) - static_cast<Unsigned>(minInclusive))
+        );
+        if (span == std::numeric_limits<std::uint64_t>::max()) {
+            return static_cast<T>(mEngine());
+        }
+        auto const offset = detail::boundedRandom(mEngine, span + 1U);
+        return static_cast<T>(static_cast<Unsigned>(minInclusive) + static_cast<Unsigned>(offset));
     }
 
     template<std::floating_point T>
     [[nodiscard]] T range(T minInclusive, T maxExclusive) noexcept {
-        std::uniform_real_distribution<T> distribution{ minInclusive, maxExclusive };
-        return distribution(mRandomEngine);
+        return minInclusive + detail::unitInterval<T>(mEngine()) * (maxExclusive - minInclusive);
     }
 
     template<std::integral T>
@@ -35,12 +102,12 @@ public:
 
     template<std::integral T>
     [[nodiscard]] T get() noexcept {
-        return range(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+        return static_cast<T>(mEngine());
     }
 
     template<std::floating_point T>
     [[nodiscard]] T get() noexcept {
-        return range(T{ 0 }, T{ 1 });
+        return detail::unitInterval<T>(mEngine());
     }
 
     [[nodiscard]] glm::vec3 unitDirection() noexcept {
@@ -50,7 +117,7 @@ public:
 
     template<typename T>
     [[nodiscard]] T sign() noexcept {
-        return static_cast<T>(range(0, 1) * 2 - 1);
+        return static_cast<T>(static_cast<int>(mEngine() >> 63U) * 2 - 1);
     }
 
     template<std::integral T>
@@ -63,7 +130,25 @@ public:
         return static_cast<T>(static_cast<int>(get<T>() <= probability) * 2 - 1);
     }
 
+    // Bulk generation, four values at a time from independent streams (vectorized by the compiler). The results
+    // are deterministic for a given seed, but differ from calling range() repeatedly.
+    void fill(std::span<float> values, float minInclusive = 0.0f, float maxExclusive = 1.0f) noexcept;
+    void fill(std::span<std::uint32_t> values) noexcept;
+    void fill(std::span<std::uint64_t> values) noexcept;
+    // bounded variant, using the multiply-shift mapping (bias is negligible for ranges far below 2^32)
+    void fill(std::span<std::uint32_t> values, std::uint32_t minInclusive, std::uint32_t maxInclusive) noexcept;
+
+    [[nodiscard]] Engine& engine() noexcept {
+        return mEngine;
+    }
+
+private:
+    template<typename Function>
+    void fillBulk(std::size_t count, Function&& store) noexcept;
+
 private:
-    std::random_device mRandomDevice;
-    std::mt19937_64 mRandomEngine;
+    Engine mEngine;
+    Xoshiro256StarStarX4 mBulkEngine;
+    std::uint64_t mSeed;
+    std::uint64_t mNumSplits{ 0 };
 };
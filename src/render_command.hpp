@@ -0,0 +1,24 @@
+#pragma once
+
+#include "color.hpp"
+#include "include_glm.hpp"
+#include "rect.hpp"
+
+class ShaderProgram;
+class Texture;
+
+struct RenderCommand {
+    glm::mat4 transformMatrix;
+    Rect textureRect;
+    Color color;
+    ShaderProgram* shader;
+    const Texture* texture;
+};
+
+[[nodiscard]] inline glm::mat4
+quadTransform(glm::vec3 const& translation, float const rotationAngle, glm::vec2 const& scale) noexcept {
+    return glm::scale(
+            glm::rotate(glm::translate(glm::mat4{ 1.0f }, translation), rotationAngle, glm::vec3{ 0.0f, 0.0f, 1.0f }),
+            glm::vec3{ scale.x, scale.y, 1.0f }
+    );
+}
@@ -0,0 +1,39 @@
+#include "render_command_list.hpp"
+
+RenderCommandList::RenderCommandList(std::size_t const capacity) {
+    mCommands.reserve(capacity);
+}
+
+void RenderCommandList::drawQuad(
+        glm::vec3 const& translation,
+        float const rotationAngle,
+        glm::vec2 const& scale,
+        ShaderProgram& shader,
+        Texture const& texture,
+        Rect const& textureRect,
+        Color const& color
+) {
+    drawQuad(quadTransform(translation, rotationAngle, scale), shader, texture, textureRect, color);
+}
+
+void RenderCommandList::drawQuad(
+        glm::mat4 const& transformMatrix,
+        ShaderProgram& shader,
+        Texture const& texture,
+        Rect const& textureRect,
+        Color const& color
+) {
+    mCommands.push_back(RenderCommand{ .transformMatrix{ transformMatrix },
+                                       .textureRect{ textureRect },
+                                       .color{ color },
+                                       .shader{ &shader },
+                                       .texture{ &texture } });
+}
+
+void RenderCommandList::clear() noexcept {
+    mCommands.clear();
+}
+
+void RenderCommandList::reserve(std::size_t const capacity) {
+    mCommands.reserve(capacity);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "render_command.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Records draw commands independently of the Renderer. Every thread (e.g. every simulation chunk) can fill
+// its own list without any synchronization, the lists are then handed to Renderer::submit() on the render
+// thread and get merged and sorted at the end of the frame.
+class RenderCommandList final {
+public:
+    RenderCommandList() = default;
+    explicit RenderCommandList(std::size_t capacity);
+
+    void drawQuad(
+            glm::vec3 const& translation,
+            float rotationAngle,
+            glm::vec2 const& scale,
+            ShaderProgram& shader,
+            Texture const& texture,
+            Rect const& textureRect = Rect::unit(),
+            Color const& color = Color::white()
+    );
+    void drawQuad(
+            glm::mat4 const& transformMatrix,
+            ShaderProgram& shader,
+            Texture const& texture,
+            Rect const& textureRect = Rect::unit(),
+            Color const& color = Color::white()
+    );
+    // keeps the allocated memory so that the list can be reused in the next frame
+    void clear() noexcept;
+    void reserve(std::size_t capacity);
+
+    [[nodiscard]] std::span<RenderCommand const> commands() const noexcept {
+        return mCommands;
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mCommands.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return mCommands.empty();
+    }
+
+private:
+    std::vector<RenderCommand> mCommands;
+};
@@ -0,0 +1,106 @@
+#include "render_target.hpp"
+#include "gl_state_cache.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+RenderTarget::RenderTarget(RenderTarget&& other) noexcept {
+    using std::swap;
+    swap(mFramebufferName, other.mFramebufferName);
+    swap(mDepthRenderbufferName, other.mDepthRenderbufferName);
+    swap(mColorTexture, other.mColorTexture);
+    swap(mDescription, other.mDescription);
+}
+
+RenderTarget::~RenderTarget() {
+    GLStateCache::instance().onFramebufferDeleted(mFramebufferName);
+    glDeleteFramebuffers(1, &mFramebufferName);
+    glDeleteRenderbuffers(1, &mDepthRenderbufferName);
+}
+
+RenderTarget& RenderTarget::operator=(RenderTarget&& other) noexcept {
+    using std::swap;
+    swap(mFramebufferName, other.mFramebufferName);
+    swap(mDepthRenderbufferName, other.mDepthRenderbufferName);
+    swap(mColorTexture, other.mColorTexture);
+    swap(mDescription, other.mDescription);
+    return *this;
+}
+
+tl::expected<RenderTarget, std::string> RenderTarget::create(RenderTargetDescription const& description) noexcept {
+    auto colorTexture = Texture::createForStorage(description.size.x, description.size.y, description.colorFormat);
+    if (!colorTexture) {
+        return tl::unexpected{ colorTexture.error() };
+    }
+    RenderTarget result;
+    result.mDescription = description;
+    result.mColorTexture = std::move(colorTexture.value());
+    glCreateFramebuffers(1, &result.mFramebufferName);
+    glNamedFramebufferTexture(result.mFramebufferName, GL_COLOR_ATTACHMENT0, result.mColorTexture.mName, 0);
+    if (description.hasDepthBuffer) {
+        glCreateRenderbuffers(1, &result.mDepthRenderbufferName);
+        glNamedRenderbufferStorage(
+                result.mDepthRenderbufferName,
+                GL_DEPTH_COMPONENT24,
+                description.size.x,
+                description.size.y
+        );
+        glNamedFramebufferRenderbuffer(
+                result.mFramebufferName,
+                GL_DEPTH_ATTACHMENT,
+                GL_RENDERBUFFER,
+                result.mDepthRenderbufferName
+        );
+    }
+    auto const status = glCheckNamedFramebufferStatus(result.mFramebufferName, GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        return tl::unexpected{ fmt::format("Framebuffer is incomplete (status 0x{:X}).", status) };
+    }
+    return result;
+}
+
+void RenderTarget::bind() const noexcept {
+    auto& cache = GLStateCache::instance();
+    cache.bindFramebuffer(mFramebufferName);
+    cache.setViewport(0, 0, mDescription.size.x, mDescription.size.y);
+}
+
+void RenderTarget::bindDefault(WindowSize const framebufferSize) noexcept {
+    auto& cache = GLStateCache::instance();
+    cache.bindFramebuffer(0U);
+    cache.setViewport(0, 0, framebufferSize.width, framebufferSize.height);
+}
+
+tl::expected<RenderTarget*, std::string> RenderTargetPool::acquire(RenderTargetDescription const& description) {
+    auto const it = std::ranges::find_if(mEntries, [&](Entry const& entry) {
+        return !entry.isInUse && entry.target->description() == description;
+    });
+    if (it != mEntries.end()) {
+        it->isInUse = true;
+        it->lastUsedFrame = mCurrentFrame;
+        return it->target.get();
+    }
+    auto target = RenderTarget::create(description);
+    if (!target) {
+        return tl::unexpected{ target.error() };
+    }
+    spdlog::info("Created {}x{} render target.", description.size.x, description.size.y);
+    mEntries.push_back(Entry{ .target{ std::make_unique<RenderTarget>(std::move(target.value())) },
+                              .isInUse{ true },
+                              .lastUsedFrame{ mCurrentFrame } });
+    return mEntries.back().target.get();
+}
+
+void RenderTargetPool::release(RenderTarget const* const target) noexcept {
+    auto const it = std::ranges::find_if(mEntries, [&](Entry const& entry) { return entry.target.get() == target; });
+    if (it != mEntries.end()) {
+        it->isInUse = false;
+    }
+}
+
+void RenderTargetPool::nextFrame() noexcept {
+    ++mCurrentFrame;
+    std::erase_if(mEntries, [this](Entry const& entry) {
+        return !entry.isInUse && mCurrentFrame - entry.lastUsedFrame > maxUnusedFrames;
+    });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "include_glm.hpp"
+#include "texture.hpp"
+#include "window_size.hpp"
+#include <cstdint>
+#include <glad/gl.h>
+#include <memory>
+#include <string>
+#include <tl/expected.hpp>
+#include <vector>
+
+struct RenderTargetDescription {
+    glm::ivec2 size{ 0, 0 };
+    GLenum colorFormat{ GL_RGBA8 };
+    bool hasDepthBuffer{ true };
+
+    [[nodiscard]] bool operator==(RenderTargetDescription const&) const = default;
+};
+
+// Framebuffer object with a color texture (sampled with nearest filtering) and an optional depth buffer.
+class RenderTarget final {
+public:
+    RenderTarget() = default;
+    RenderTarget(RenderTarget const&) = delete;
+    RenderTarget(RenderTarget&& other) noexcept;
+    ~RenderTarget();
+
+    RenderTarget& operator=(RenderTarget const&) = delete;
+    RenderTarget& operator=(RenderTarget&& other) noexcept;
+
+    [[nodiscard]] static tl::expected<RenderTarget, std::string> create(RenderTargetDescription const& description
+    ) noexcept;
+
+    // binds the target for drawing and adjusts the viewport to its size
+    void bind() const noexcept;
+    static void bindDefault(WindowSize framebufferSize) noexcept;
+    [[nodiscard]] Texture const& colorTexture() const noexcept {
+        return mColorTexture;
+    }
+    [[nodiscard]] RenderTargetDescription const& description() const noexcept {
+        return mDescription;
+    }
+
+private:
+    GLuint mFramebufferName{ 0U };
+    GLuint mDepthRenderbufferName{ 0U };
+    Texture mColorTexture;
+    RenderTargetDescription mDescription;
+};
+
+// Reuses render targets across frames. Targets that haven't been acquired for a while are deleted.
+class RenderTargetPool final {
+public:
+    static constexpr std::uint64_t maxUnusedFrames = 120;
+
+public:
+    // the target stays valid (and reserved) until it is released
+    [[nodiscard]] tl::expected<RenderTarget*, std::string> acquire(RenderTargetDescription const& description);
+    void release(RenderTarget const* target) noexcept;
+    void nextFrame() noexcept;
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mEntries.size();
+    }
+
+private:
+    struct Entry {
+        std::unique_ptr<RenderTarget> target;
+        bool isInUse;
+        std::uint64_t lastUsedFrame;
+    };
+
+private:
+    std::vector<Entry> mEntries;
+    std::uint64_t mCurrentFrame{ 0ULL };
+};
@@ -0,0 +1,101 @@
+#include "render_thread.hpp"
+#include "gl_state_cache.hpp"
+#include "gpu_timer.hpp"
+#include "renderer.hpp"
+#include "scoped_timer.hpp"
+#include "window.hpp"
+#include <cassert>
+#include <imgui_impl_opengl3.h>
+
+ImGuiDrawDataSnapshot::~ImGuiDrawDataSnapshot() {
+    clear();
+}
+
+void ImGuiDrawDataSnapshot::capture(ImDrawData const& drawData) {
+    clear();
+    mDrawData = drawData;
+    for (auto& drawList : mDrawData.CmdLists) {
+        drawList = drawList->CloneOutput();
+    }
+}
+
+void ImGuiDrawDataSnapshot::clear() noexcept {
+    for (auto const drawList : mDrawData.CmdLists) {
+        IM_DELETE(drawList);
+    }
+    mDrawData.Clear();
+}
+
+void FramePacket::clear() noexcept {
+    renderTasks.clear();
+    commands.clear();
+    imGuiDrawData.clear();
+    arena.reset();
+}
+
+RenderThread::RenderThread(Window const& window, Renderer& renderer)
+    : mWindow{ window },
+      mRenderer{ renderer } {
+    for (auto& packet : mPackets) {
+        mFreeFrames.push(&packet);
+    }
+    glfwMakeContextCurrent(nullptr);
+    mThread = std::thread{ [this] { run(); } };
+}
+
+RenderThread::~RenderThread() {
+    auto& lastFrame = beginFrame();
+    lastFrame.isLastFrame = true;
+    submitFrame();
+    mThread.join();
+    glfwMakeContextCurrent(mWindow.getGLFWWindowPointer());
+}
+
+FramePacket& RenderThread::beginFrame() noexcept {
+    SCOPED_TIMER_NAMED("wait for free frame");
+    assert(mCurrentFrame == nullptr);
+    mCurrentFrame = mFreeFrames.pop();
+    return *mCurrentFrame;
+}
+
+void RenderThread::submitFrame() noexcept {
+    assert(mCurrentFrame != nullptr);
+    mSubmittedFrames.push(mCurrentFrame);
+    mCurrentFrame = nullptr;
+}
+
+void RenderThread::run() noexcept {
+    ScopedTimer::setThreadName("render thread");
+    glfwMakeContextCurrent(mWindow.getGLFWWindowPointer());
+    while (true) {
+        auto const packet = mSubmittedFrames.pop();
+        if (packet->isLastFrame) {
+            break;
+        }
+        renderFrame(*packet);
+        packet->clear();
+        mFreeFrames.push(packet);
+        FrameArena::threadLocal().reset();
+    }
+    glFinish();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::renderFrame(FramePacket& packet) noexcept {
+    SCOPED_TIMER();
+    for (auto const& task : packet.renderTasks) {
+        task();
+    }
+    mRenderer.beginFrame(packet.viewMatrix, packet.time);
+    Renderer::setClearColor(packet.clearColor);
+    Renderer::clear(true, true);
+    mRenderer.submit(packet.commands);
+    mRenderer.endFrame();
+    {
+        GPU_SCOPED_TIMER_NAMED("ImGui");
+        ImGui_ImplOpenGL3_RenderDrawData(packet.imGuiDrawData.drawData());
+    }
+    mWindow.swapBuffers();
+    GLStateCache::instance().nextFrame();
+    GpuTimer::nextFrame();
+}
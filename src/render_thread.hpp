@@ -0,0 +1,92 @@
+#pragma once
+
+#include "color.hpp"
+#include "frame_arena.hpp"
+#include "include_glm.hpp"
+#include "render_command_list.hpp"
+#include "spsc_queue.hpp"
+#include "time.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <imgui.h>
+#include <thread>
+#include <vector>
+
+class Renderer;
+class Window;
+
+// Deep copy of the ImGui draw data of a frame. The original draw lists are owned by ImGui and get overwritten
+// as soon as the next frame starts.
+class ImGuiDrawDataSnapshot final {
+public:
+    ImGuiDrawDataSnapshot() = default;
+    ImGuiDrawDataSnapshot(ImGuiDrawDataSnapshot const&) = delete;
+    ImGuiDrawDataSnapshot(ImGuiDrawDataSnapshot&&) = delete;
+    ImGuiDrawDataSnapshot& operator=(ImGuiDrawDataSnapshot const&) = delete;
+    ImGuiDrawDataSnapshot& operator=(ImGuiDrawDataSnapshot&&) = delete;
+    ~ImGuiDrawDataSnapshot();
+
+    void capture(ImDrawData const& drawData);
+    void clear() noexcept;
+    [[nodiscard]] ImDrawData* drawData() noexcept {
+        return &mDrawData;
+    }
+
+private:
+    ImDrawData mDrawData;
+};
+
+// Everything the render thread needs to render one frame. Shaders and textures referenced by the commands
+// have to stay alive until the frame has been rendered.
+struct FramePacket {
+    glm::mat4 viewMatrix{ 1.0f };
+    Time time;
+    Color clearColor{ 0.0f, 0.0f, 0.0f, 1.0f };
+    // executed on the render thread before the commands are drawn, e.g. for texture uploads
+    std::vector<std::function<void()>> renderTasks;
+    RenderCommandList commands;
+    ImGuiDrawDataSnapshot imGuiDrawData;
+    // transient data of the frame (e.g. for the render tasks), stays valid until the frame has been rendered
+    FrameArena arena;
+    bool isLastFrame{ false };
+
+    void clear() noexcept;
+};
+
+// Owns the OpenGL context while it is running. The main thread records frame N+1 into a FramePacket while the
+// render thread submits frame N to the driver and presents it.
+class RenderThread final {
+public:
+    static constexpr std::size_t maxFramesInFlight = 2;
+
+public:
+    // takes the context away from the calling thread
+    RenderThread(Window const& window, Renderer& renderer);
+    RenderThread(RenderThread const&) = delete;
+    RenderThread(RenderThread&&) = delete;
+    RenderThread& operator=(RenderThread const&) = delete;
+    RenderThread& operator=(RenderThread&&) = delete;
+    // waits for all submitted frames and makes the context current on the calling thread again
+    ~RenderThread();
+
+    // blocks while maxFramesInFlight frames are waiting to be rendered
+    [[nodiscard]] FramePacket& beginFrame() noexcept;
+    void submitFrame() noexcept;
+
+private:
+    void run() noexcept;
+    void renderFrame(FramePacket& packet) noexcept;
+
+private:
+    static constexpr std::size_t queueCapacity = std::bit_ceil(maxFramesInFlight);
+
+    Window const& mWindow;
+    Renderer& mRenderer;
+    std::array<FramePacket, maxFramesInFlight> mPackets;
+    SpscQueue<FramePacket*, queueCapacity> mSubmittedFrames;
+    SpscQueue<FramePacket*, queueCapacity> mFreeFrames;
+    FramePacket* mCurrentFrame{ nullptr };
+    std::thread mThread;
+};
@@ -4,42 +4,155 @@
 
 #include "renderer.hpp"
 #include "gl_data_usage_pattern.hpp"
-#include "hash/hash.hpp"
+#include "gl_state_cache.hpp"
+#include "gpu_timer.hpp"
 #include "scoped_timer.hpp"
+#include "trace_capture.hpp"
+#include <chrono>
+#include <tuple>
 
-Renderer::Renderer(Window const& window)
-    : mVertexBuffer(
+namespace {
+    constexpr auto upscaleVertexShaderSource = R"(#version 450 core
+
+out vec2 texCoords;
+
+void main() {
+    // a single triangle that covers the whole viewport
+    vec2 position = vec2(float((gl_VertexID & 1) << 2) - 1.0, float((gl_VertexID & 2) << 1) - 1.0);
+    texCoords = position * 0.5 + 0.5;
+    gl_Position = vec4(position, 0.0, 1.0);
+})";
+
+    constexpr auto upscaleFragmentShaderSource = R"(#version 450 core
+
+in vec2 texCoords;
+
+out vec4 FragColor;
+
+layout (binding = 0) uniform sampler2D uSource;
+
+void main() {
+    FragColor = texture(uSource, texCoords);
+})";
+} // namespace
+
+Renderer::Renderer(Window const& window, VertexFormat vertexFormat, SubmissionMode submissionMode)
+    : mVertexFormat{ vertexFormat },
+      mVertexSize{ vertexSize(vertexFormat) },
+      mSubmissionMode{ submissionMode },
+      mVertexBuffer(
               GLDataUsagePattern::StreamDraw,
-              maxCommandsPerBatch * 4ULL * sizeof(VertexData),
+              gsl::narrow_cast<GLsizeiptr>(maxVerticesPerBatch * mVertexSize),
               maxCommandsPerBatch * 6ULL * sizeof(IndexData)
       ),
+      mFrameUniformBuffer{ sizeof(FrameUniforms) },
       mWindow{ window } {
     mCommandBuffer.resize(maxCommandsPerBatch);
-    mVertexData.resize(maxCommandsPerBatch * 4ULL);
+    mVertexData.resize(maxVerticesPerBatch * mVertexSize);
     mIndexData.resize(maxCommandsPerBatch * 6ULL);
     mCommandIterator = mCommandBuffer.begin();
-    mVertexIterator = mVertexData.begin();
-    mIndexIterator = mIndexData.begin();
-    mCurrentTextureNames.reserve(std::min(Texture::getTextureUnitCount(), 32));
+    mCurrentTextureNames.reserve(std::min(
+            static_cast<std::size_t>(Texture::getTextureUnitCount()),
+            ShaderProgram::maxTextureArraySize
+    ));
     spdlog::info("GPU is capable of binding {} textures at a time.", mCurrentTextureNames.capacity());
-    mVertexBuffer.setVertexAttributeLayout(
-            VertexAttributeDefinition{ 3, GL_FLOAT, false },
-            VertexAttributeDefinition{ 4, GL_FLOAT, false },
-            VertexAttributeDefinition{ 2, GL_FLOAT, false },
-            VertexAttributeDefinition{ 1, GL_UNSIGNED_INT, false }
-    );
+    auto const setLayout = [this](auto const& layout) {
+        std::apply([this](auto const&... definitions) { mVertexBuffer.setVertexAttributeLayout(definitions...); }, layout);
+    };
+    switch (mVertexFormat) {
+        case VertexFormat::Standard:
+            setLayout(StandardVertex::layout());
+            break;
+        case VertexFormat::Compact:
+            setLayout(CompactVertex::layout());
+            break;
+        case VertexFormat::CompactHalfPosition:
+            setLayout(CompactHalfPositionVertex::layout());
+            break;
+    }
+    spdlog::info("Renderer uses a vertex size of {} bytes.", mVertexSize);
+    if (mSubmissionMode == SubmissionMode::MultiDrawIndirect
+        && !glfwExtensionSupported("GL_ARB_shader_draw_parameters")) {
+        spdlog::warn("GL_ARB_shader_draw_parameters is not supported, shaders cannot access the draw metadata.");
+    }
+    [[maybe_unused]] bool const success = mUpscaleProgram.compile(upscaleVertexShaderSource, upscaleFragmentShaderSource);
+    assert(success);
+    glCreateVertexArrays(1, &mEmptyVertexArrayName);
+}
+
+Renderer::~Renderer() {
+    GLStateCache::instance().onVertexArrayDeleted(mEmptyVertexArrayName);
+    glDeleteVertexArrays(1, &mEmptyVertexArrayName);
+}
+
+void Renderer::setVirtualResolution(std::optional<glm::ivec2> const resolution) noexcept {
+    mVirtualResolution = resolution;
+}
+
+glm::vec2 Renderer::toVirtualPosition(glm::vec2 const windowPosition) const noexcept {
+    auto const windowSize = mWindow.framebufferSize();
+    if (!mVirtualResolution) {
+        return windowPosition + glm::vec2{ glm::ivec2{ windowSize.width, windowSize.height } } / 2.0f;
+    }
+    // the upscaled image is centered in the window
+    auto const scale = static_cast<float>(upscaleFactor(windowSize, *mVirtualResolution));
+    return windowPosition / scale + glm::vec2{ *mVirtualResolution } / 2.0f;
 }
 
-void Renderer::beginFrame(glm::mat4 const& viewMatrix) noexcept {
-    mVertexIterator = mVertexData.begin();
-    mIndexIterator = mIndexData.begin();
+void Renderer::beginFrame(glm::mat4 const& viewMatrix, Time const& time) noexcept {
+    mNumVertices = 0U;
+    mNumIndexData = 0U;
+    mBatchFirstVertex = 0U;
+    mBatchFirstIndexData = 0U;
     mRenderStats = RenderStats{};
     mCurrentViewProjectionMatrix = /*CameraComponent::projectionMatrix(mWindow.framebufferSize()) * */ viewMatrix;
+    mFrameUniformBuffer.setData(FrameUniforms{ .projectionMatrix{ mCurrentViewProjectionMatrix },
+                                               .time{ static_cast<float>(time.elapsed) },
+                                               .deltaTime{ static_cast<float>(time.delta) },
+                                               .padding{} });
+    mFrameUniformBuffer.bind(frameUniformsBindingPoint);
+
+    if (mVirtualResolution) {
+        auto const target = mRenderTargetPool.acquire(RenderTargetDescription{ .size{ *mVirtualResolution } });
+        if (target) {
+            mCurrentRenderTarget = target.value();
+            mCurrentRenderTarget->bind();
+        } else {
+            spdlog::error("Rendering at window resolution: {}", target.error());
+            mVirtualResolution.reset();
+        }
+    }
+    if (mCurrentRenderTarget == nullptr) {
+        mWindow.bindFramebuffer();
+    }
 }
 
 void Renderer::endFrame() noexcept {
+    auto const startTime = std::chrono::steady_clock::now();
+    {
+        SCOPED_TIMER_NAMED("merge command lists");
+        for (auto const commandList : mSubmittedCommandLists) {
+            appendCommands(commandList->commands());
+        }
+        mSubmittedCommandLists.clear();
+    }
     flushCommandBuffer();
     flushVertexAndIndexData();
+    if (mSubmissionMode == SubmissionMode::MultiDrawIndirect) {
+        submitIndirectBatches();
+    }
+    if (mCurrentRenderTarget != nullptr) {
+        upscaleToWindow();
+        mRenderTargetPool.release(mCurrentRenderTarget);
+        mCurrentRenderTarget = nullptr;
+    }
+    mRenderTargetPool.nextFrame();
+    mRenderStats.flushDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    ++mNumEndedFrames;
+    TraceCapture::counter("quads", static_cast<double>(mRenderStats.numTriangles / 2));
+    TraceCapture::counter("batches", static_cast<double>(mRenderStats.numBatches));
+    TraceCapture::counter("draw calls", static_cast<double>(mRenderStats.numDrawCalls));
+    TraceCapture::counter("uploaded bytes", static_cast<double>(mRenderStats.numUploadedBytes));
     //spdlog::info("Drawing {} quads in {} batches", mRenderStats.numTriangles / 2, mRenderStats.numBatches);
 }
 
@@ -52,20 +165,7 @@ void Renderer::drawQuad(
         Rect const& textureRect,
         Color const& color
 ) noexcept {
-    drawQuad(
-            glm::scale(
-                    glm::rotate(
-                            glm::translate(glm::mat4{ 1.0f }, translation),
-                            rotationAngle,
-                            glm::vec3{ 0.0f, 0.0f, 1.0f }
-                    ),
-                    glm::vec3{ scale.x, scale.y, 1.0f }
-            ),
-            shader,
-            texture,
-            textureRect,
-            color
-    );
+    drawQuad(quadTransform(translation, rotationAngle, scale), shader, texture, textureRect, color);
 }
 
 void Renderer::drawQuad(
@@ -85,6 +185,62 @@ void Renderer::drawQuad(
                                          .texture{ &texture } };
 }
 
+void Renderer::drawParticles(ParticleSystem const& particleSystem, ShaderProgram& shader, Texture const& texture) noexcept {
+    SCOPED_TIMER();
+    flushCommandBuffer();
+    mCurrentShader = &shader;
+    mCurrentTextureCapacity = std::min(mCurrentTextureNames.capacity(), shader.textureArraySize());
+    if (mSubmissionMode == SubmissionMode::Immediate) {
+        useShader(shader);
+    }
+    std::size_t first = 0;
+    while (first < particleSystem.size()) {
+        auto numQuads = particleSystem.size() - first;
+        if (mSubmissionMode == SubmissionMode::Immediate) {
+            numQuads = std::min(numQuads, (maxVerticesPerBatch - mNumVertices) / 4U);
+            if (numQuads == 0) {
+                flushVertexAndIndexData();
+                continue;
+            }
+        } else {
+            reserveVertexAndIndexData(mNumVertices + numQuads * 4U, mNumIndexData + numQuads * 2U);
+        }
+        if (mCurrentTextureNames.empty()) {
+            mCurrentTextureNames.push_back(texture.mName);
+        }
+        switch (mVertexFormat) {
+            case VertexFormat::Standard:
+                particleSystem.writeQuadVertices(nextVertices<StandardVertex>(), first, numQuads, 0U);
+                break;
+            case VertexFormat::Compact:
+                particleSystem.writeQuadVertices(nextVertices<CompactVertex>(), first, numQuads, 0U);
+                break;
+            case VertexFormat::CompactHalfPosition:
+                particleSystem.writeQuadVertices(nextVertices<CompactHalfPositionVertex>(), first, numQuads, 0U);
+                break;
+        }
+        addQuadIndexData(numQuads);
+        first += numQuads;
+    }
+    flushVertexAndIndexData();
+}
+
+void Renderer::submit(RenderCommandList const& commandList) {
+    mSubmittedCommandLists.push_back(&commandList);
+}
+
+void Renderer::appendCommands(std::span<RenderCommand const> commands) noexcept {
+    while (!commands.empty()) {
+        if (mCommandIterator == mCommandBuffer.end()) {
+            flushCommandBuffer();
+        }
+        auto const count =
+                std::min(commands.size(), static_cast<std::size_t>(mCommandBuffer.end() - mCommandIterator));
+        mCommandIterator = std::copy_n(commands.begin(), count, mCommandIterator);
+        commands = commands.subspan(count);
+    }
+}
+
 void Renderer::flushCommandBuffer() noexcept {
     SCOPED_TIMER();
     if (mCommandIterator == mCommandBuffer.begin()) {
@@ -106,11 +262,13 @@ void Renderer::flushCommandBuffer() noexcept {
     );
 
     while (currentStartIt != mCommandIterator) { // one iteration per shader
-        mVertexIterator = mVertexData.begin();
-        mIndexIterator = mIndexData.begin();
         mCurrentTextureNames.clear();
-        currentStartIt->shader->bind();
-        currentStartIt->shader->setUniform(hash::staticHashString("projectionMatrix"), mCurrentViewProjectionMatrix);
+        mCurrentShader = currentStartIt->shader;
+        // specialized shader variants can have a smaller texture array
+        mCurrentTextureCapacity = std::min(mCurrentTextureNames.capacity(), mCurrentShader->textureArraySize());
+        if (mSubmissionMode == SubmissionMode::Immediate) {
+            useShader(*mCurrentShader);
+        }
         {
             SCOPED_TIMER_NAMED("commands to data");
             std::for_each(currentStartIt, currentEndIt, [&](RenderCommand const& renderCommand) {
@@ -134,29 +292,187 @@ void Renderer::flushCommandBuffer() noexcept {
     mCommandIterator = mCommandBuffer.begin();
 }
 
+void Renderer::useShader(ShaderProgram const& shader) const noexcept {
+    shader.bind();
+    // shaders without the FrameData block get the matrix as a plain uniform
+    if (shader.mProjectionMatrixUniform.isValid()) {
+        shader.setUniform(shader.mProjectionMatrixUniform, mCurrentViewProjectionMatrix);
+    }
+}
+
 void Renderer::flushVertexAndIndexData() noexcept {
-    if (mVertexIterator == mVertexData.begin()) {
+    if (mNumVertices == mBatchFirstVertex) {
         return;
     }
+    if (mSubmissionMode == SubmissionMode::MultiDrawIndirect) {
+        // the data of the whole frame is submitted at the end of the frame
+        recordIndirectBatch();
+    } else {
+        mVertexBuffer.bind();
+        // flush all buffers
+        {
+            SCOPED_TIMER_NAMED("submit data");
+            GPU_SCOPED_TIMER_NAMED("submit data");
+            mVertexBuffer.submitVertexData(std::span{ mVertexData.data(), mNumVertices * mVertexSize });
+            mVertexBuffer.submitIndexData(std::span{ mIndexData.data(), mNumIndexData });
+            mRenderStats.numUploadedBytes += mNumVertices * mVertexSize + mNumIndexData * sizeof(IndexData);
+        }
+        for (std::size_t i = 0; i < mCurrentTextureNames.size(); ++i) {
+            Texture::bind(mCurrentTextureNames[i], gsl::narrow_cast<GLint>(i));
+        }
+        {
+            GPU_SCOPED_TIMER_NAMED("draw");
+            glDrawElements(
+                    GL_TRIANGLES,
+                    gsl::narrow_cast<GLsizei>(mVertexBuffer.indicesCount()),
+                    GL_UNSIGNED_INT,
+                    nullptr
+            );
+        }
+        mRenderStats.numDrawCalls += 1ULL;
+        mNumVertices = 0U;
+        mNumIndexData = 0U;
+    }
+    mCurrentTextureNames.clear();
+    mNumTrianglesInCurrentBatch = 0ULL;
+    mRenderStats.numBatches += 1ULL;
+}
+
+void Renderer::recordIndirectBatch() {
+    mIndirectCommands.push_back(DrawElementsIndirectCommand{
+            .count{ gsl::narrow_cast<GLuint>((mNumIndexData - mBatchFirstIndexData) * 3U) },
+            .instanceCount{ 1U },
+            .firstIndex{ gsl::narrow_cast<GLuint>(mBatchFirstIndexData * 3U) },
+            .baseVertex{ gsl::narrow_cast<GLint>(mBatchFirstVertex) },
+            .baseInstance{ 0U }, // assigned when the batches are merged into draw calls
+    });
+    mDrawMetadata.push_back(DrawMetadata{
+            .firstVertex{ gsl::narrow_cast<GLuint>(mBatchFirstVertex) },
+            .numVertices{ gsl::narrow_cast<GLuint>(mNumVertices - mBatchFirstVertex) },
+            .numTextures{ gsl::narrow_cast<GLuint>(mCurrentTextureNames.size()) },
+            .padding{ 0U },
+    });
+    mIndirectBatches.push_back(IndirectBatch{
+            .shader{ mCurrentShader },
+            .firstTextureName{ mIndirectTextureNames.size() },
+            .numTextureNames{ mCurrentTextureNames.size() },
+    });
+    mIndirectTextureNames.insert(mIndirectTextureNames.end(), mCurrentTextureNames.cbegin(), mCurrentTextureNames.cend());
+    mBatchFirstVertex = mNumVertices;
+    mBatchFirstIndexData = mNumIndexData;
+}
+
+void Renderer::submitIndirectBatches() noexcept {
+    if (mIndirectBatches.empty()) {
+        return;
+    }
+    auto const haveSameState = [this](IndirectBatch const& lhs, IndirectBatch const& rhs) {
+        return lhs.shader == rhs.shader && std::ranges::equal(textureNamesOf(lhs), textureNamesOf(rhs));
+    };
+
+    // gl_DrawIDARB starts at zero for every draw call, so the base instance of every command
+    // is set to the index of the first command of its draw call
+    std::size_t firstBatchOfDrawCall = 0;
+    for (std::size_t i = 0; i < mIndirectBatches.size(); ++i) {
+        if (i > 0 && !haveSameState(mIndirectBatches[i - 1], mIndirectBatches[i])) {
+            firstBatchOfDrawCall = i;
+        }
+        mIndirectCommands[i].baseInstance = gsl::narrow_cast<GLuint>(firstBatchOfDrawCall);
+    }
+
     mVertexBuffer.bind();
-    // flush all buffers
     {
         SCOPED_TIMER_NAMED("submit data");
-        mVertexBuffer.submitVertexData(mVertexData.begin(), mVertexIterator);
-        mVertexBuffer.submitIndexData(mIndexData.begin(), mIndexIterator);
+        GPU_SCOPED_TIMER_NAMED("submit data");
+        mVertexBuffer.submitVertexData(std::span{ mVertexData.data(), mNumVertices * mVertexSize });
+        mVertexBuffer.submitIndexData(std::span{ mIndexData.data(), mNumIndexData });
+        mRenderStats.numUploadedBytes += mNumVertices * mVertexSize + mNumIndexData * sizeof(IndexData);
+        mIndirectDrawBuffer.submit(mIndirectCommands, mDrawMetadata);
     }
-    for (std::size_t i = 0; i < mCurrentTextureNames.size(); ++i) {
-        Texture::bind(mCurrentTextureNames[i], gsl::narrow_cast<GLint>(i));
+    mIndirectDrawBuffer.bind(drawMetadataBindingPoint);
+
+    ShaderProgram const* boundShader = nullptr;
+    for (std::size_t first = 0; first < mIndirectBatches.size();) {
+        auto last = first + 1;
+        while (last < mIndirectBatches.size() && haveSameState(mIndirectBatches[first], mIndirectBatches[last])) {
+            ++last;
+        }
+        auto const& batch = mIndirectBatches[first];
+        if (batch.shader != boundShader) {
+            useShader(*batch.shader);
+            boundShader = batch.shader;
+        }
+        auto const textureNames = textureNamesOf(batch);
+        for (std::size_t i = 0; i < textureNames.size(); ++i) {
+            Texture::bind(textureNames[i], gsl::narrow_cast<GLint>(i));
+        }
+        {
+            GPU_SCOPED_TIMER_NAMED("draw");
+            glMultiDrawElementsIndirect(
+                    GL_TRIANGLES,
+                    GL_UNSIGNED_INT,
+                    reinterpret_cast<void const*>(first * sizeof(DrawElementsIndirectCommand)),
+                    gsl::narrow_cast<GLsizei>(last - first),
+                    0
+            );
+        }
+        mRenderStats.numDrawCalls += 1ULL;
+        first = last;
+    }
+
+    mNumVertices = 0U;
+    mNumIndexData = 0U;
+    mBatchFirstVertex = 0U;
+    mBatchFirstIndexData = 0U;
+    mIndirectBatches.clear();
+    mIndirectTextureNames.clear();
+    mIndirectCommands.clear();
+    mDrawMetadata.clear();
+}
+
+void Renderer::upscaleToWindow() noexcept {
+    SCOPED_TIMER();
+    GPU_SCOPED_TIMER_NAMED("upscale");
+    auto const windowSize = mWindow.framebufferSize();
+    auto const virtualSize = mCurrentRenderTarget->description().size;
+    auto const scale = upscaleFactor(windowSize, virtualSize);
+    auto const scaledSize = virtualSize * scale;
+
+    mWindow.bindFramebuffer();
+    // the area around the upscaled image keeps the clear color
+    clear(true, true);
+    auto& cache = GLStateCache::instance();
+    cache.setViewport(
+            (windowSize.width - scaledSize.x) / 2,
+            (windowSize.height - scaledSize.y) / 2,
+            scaledSize.x,
+            scaledSize.y
+    );
+    cache.setDepthTestEnabled(false);
+    mUpscaleProgram.bind();
+    Texture::bind(mCurrentRenderTarget->colorTexture().mName, 0);
+    cache.bindVertexArray(mEmptyVertexArrayName);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    mRenderStats.numDrawCalls += 1ULL;
+    cache.setDepthTestEnabled(true);
+    // everything drawn afterwards (e.g. ImGui) covers the whole window
+    cache.setViewport(0, 0, windowSize.width, windowSize.height);
+}
+
+int Renderer::upscaleFactor(WindowSize const windowSize, glm::ivec2 const virtualSize) noexcept {
+    return std::max(1, std::min(windowSize.width / virtualSize.x, windowSize.height / virtualSize.y));
+}
+
+void Renderer::reserveVertexAndIndexData(std::size_t const numVertices, std::size_t const numIndexData) {
+    if (numVertices * mVertexSize > mVertexData.size()) {
+        mVertexData.resize(std::max(mVertexData.size() * 2U, numVertices * mVertexSize));
+    }
+    if (numIndexData > mIndexData.size()) {
+        mIndexData.resize(std::max(mIndexData.size() * 2U, numIndexData));
     }
-    glDrawElements(GL_TRIANGLES, gsl::narrow_cast<GLsizei>(mVertexBuffer.indicesCount()), GL_UNSIGNED_INT, nullptr);
-    mVertexIterator = mVertexData.begin();
-    mIndexIterator = mIndexData.begin();
-    mCurrentTextureNames.clear();
-    mNumTrianglesInCurrentBatch = 0ULL;
-    mRenderStats.numBatches += 1ULL;
 }
 
-void Renderer::addVertexAndIndexDataFromRenderCommand(Renderer::RenderCommand const& renderCommand) {
+void Renderer::addVertexAndIndexDataFromRenderCommand(RenderCommand const& renderCommand) {
     // TODO: use an indirection vector to optimize this as soon as there is a global asset manager
     GLuint textureIndex = 0;
     bool foundTexture = false;
@@ -169,44 +485,62 @@ void Renderer::addVertexAndIndexDataFromRenderCommand(Renderer::RenderCommand co
         }
     }
 
-    if ((!foundTexture && mCurrentTextureNames.size() == mCurrentTextureNames.capacity())
-        || (mVertexData.end() - mVertexIterator) < 4) {
+    bool const batchIsFull =
+            mSubmissionMode == SubmissionMode::Immediate && mNumVertices + 4U > maxVerticesPerBatch;
+    if ((!foundTexture && mCurrentTextureNames.size() >= mCurrentTextureCapacity) || batchIsFull) {
         flushVertexAndIndexData();
     }
+    if (mSubmissionMode == SubmissionMode::MultiDrawIndirect) {
+        reserveVertexAndIndexData(mNumVertices + 4U, mNumIndexData + 2U);
+    }
     if (!foundTexture) {
         textureIndex = static_cast<GLuint>(mCurrentTextureNames.size());
         mCurrentTextureNames.push_back(renderCommand.texture->mName);
     }
 
-    auto const indexOffset = gsl::narrow_cast<GLuint>(mVertexIterator - mVertexData.begin());
-    constexpr std::array<glm::vec4, 4> positions{
-        glm::vec4{ -1.0f, -1.0f, 0.0f, 1.0f },
-        glm::vec4{  1.0f, -1.0f, 0.0f, 1.0f },
-        glm::vec4{  1.0f,  1.0f, 0.0f, 1.0f },
-        glm::vec4{ -1.0f,  1.0f, 0.0f, 1.0f }
-    };
-    std::array<glm::vec2, 4> const texCoords{
-        glm::vec2{  renderCommand.textureRect.left, renderCommand.textureRect.bottom },
-        glm::vec2{ renderCommand.textureRect.right, renderCommand.textureRect.bottom },
-        glm::vec2{ renderCommand.textureRect.right,    renderCommand.textureRect.top },
-        glm::vec2{  renderCommand.textureRect.left,    renderCommand.textureRect.top }
-    };
-    for (std::size_t i = 0; i < 4; ++i) {
-        mVertexIterator->position = renderCommand.transformMatrix * positions[i];
-        mVertexIterator->color = renderCommand.color;
-        mVertexIterator->texCoords = texCoords[i];
-        mVertexIterator->texIndex = textureIndex;
-        ++mVertexIterator;
-    }
-    for (GLuint i = 1; i <= 2; ++i) {
-        mIndexIterator->i0 = indexOffset;
-        mIndexIterator->i1 = indexOffset + i;
-        mIndexIterator->i2 = indexOffset + i + 1;
-        ++mIndexIterator;
-    }
-    mNumTrianglesInCurrentBatch += 2ULL;
-    mRenderStats.numVertices += 4ULL;
-    mRenderStats.numTriangles += 2ULL;
+    switch (mVertexFormat) {
+        case VertexFormat::Standard:
+            writeQuadVertices(
+                    nextVertices<StandardVertex>(),
+                    renderCommand.transformMatrix,
+                    renderCommand.textureRect,
+                    renderCommand.color,
+                    textureIndex
+            );
+            break;
+        case VertexFormat::Compact:
+            writeQuadVertices(
+                    nextVertices<CompactVertex>(),
+                    renderCommand.transformMatrix,
+                    renderCommand.textureRect,
+                    renderCommand.color,
+                    textureIndex
+            );
+            break;
+        case VertexFormat::CompactHalfPosition:
+            writeQuadVertices(
+                    nextVertices<CompactHalfPositionVertex>(),
+                    renderCommand.transformMatrix,
+                    renderCommand.textureRect,
+                    renderCommand.color,
+                    textureIndex
+            );
+            break;
+    }
+    addQuadIndexData(1U);
+}
+
+void Renderer::addQuadIndexData(std::size_t const numQuads) noexcept {
+    // expects the vertices of the quads to have been written at mNumVertices already
+    for (std::size_t quad = 0; quad < numQuads; ++quad) {
+        auto const indexOffset = gsl::narrow_cast<GLuint>(mNumVertices - mBatchFirstVertex);
+        mIndexData[mNumIndexData++] = IndexData{ indexOffset, indexOffset + 1U, indexOffset + 2U };
+        mIndexData[mNumIndexData++] = IndexData{ indexOffset, indexOffset + 2U, indexOffset + 3U };
+        mNumVertices += 4U;
+    }
+    mNumTrianglesInCurrentBatch += 2ULL * numQuads;
+    mRenderStats.numVertices += 4ULL * numQuads;
+    mRenderStats.numTriangles += 2ULL * numQuads;
 }
 
 void Renderer::clear(bool colorBuffer, bool depthBuffer) noexcept {
@@ -4,9 +4,19 @@
 
 #pragma once
 
+#include "indirect_draw_buffer.hpp"
+#include "particle_system.hpp"
+#include "render_command.hpp"
+#include "render_command_list.hpp"
+#include "render_target.hpp"
 #include "vertex_buffer.hpp"
+#include "vertex_format.hpp"
+#include <array>
+#include <optional>
 #include "shader_program.hpp"
 #include "texture.hpp"
+#include "time.hpp"
+#include "uniform_buffer.hpp"
 #include "color.hpp"
 #include "window.hpp"
 #include "rect.hpp"
@@ -15,19 +25,32 @@
         std::uint64_t numBatches{ 0ULL };
         std::uint64_t numTriangles{ 0ULL };
         std::uint64_t numVertices{ 0ULL };
+        std::uint64_t numDrawCalls{ 0ULL };
+        std::uint64_t numUploadedBytes{ 0ULL };
+        // CPU time spent in endFrame() (seconds)
+        double flushDuration{ 0.0 };
+    };
+
+    // std140 layout of the FrameData uniform block
+    struct FrameUniforms {
+        glm::mat4 projectionMatrix;
+        float time;
+        float deltaTime;
+        std::array<float, 2> padding;
+    };
+    static_assert(sizeof(FrameUniforms) == 16 * sizeof(float) + 4 * sizeof(float));
+
+    enum class SubmissionMode {
+        // every batch is uploaded and drawn on its own
+        Immediate,
+        // the whole frame is uploaded once and batches sharing a shader and texture set are
+        // submitted with a single glMultiDrawElementsIndirect call
+        MultiDrawIndirect,
     };
 
     class Renderer final {
     public:
-        struct VertexData {
-            glm::vec3 position;
-            glm::vec4 color;
-            glm::vec2 texCoords;
-            GLuint texIndex;
-        };
-        static_assert(alignof(VertexData) == 4);
-        static_assert(sizeof(VertexData[2]) == 2 * sizeof(VertexData));
-        static_assert(sizeof(VertexData) == 10 * sizeof(GLfloat));
+        using VertexData = StandardVertex;
 
         struct IndexData {
             GLuint i0, i1, i2;
@@ -37,9 +60,24 @@
         static_assert(sizeof(IndexData[2]) == 2 * sizeof(IndexData));
 
     public:
-        Renderer(const Window& window);
+        // shader storage buffer binding point of the per-draw DrawMetadata array (multi draw indirect only)
+        static constexpr GLuint drawMetadataBindingPoint = 0U;
+        // uniform buffer binding point of the FrameData block, shared by all shaders
+        static constexpr GLuint frameUniformsBindingPoint = 0U;
+
+    public:
+        Renderer(
+                const Window& window,
+                VertexFormat vertexFormat = VertexFormat::Standard,
+                SubmissionMode submissionMode = SubmissionMode::Immediate
+        );
+        Renderer(const Renderer&) = delete;
+        Renderer(Renderer&&) = delete;
+        Renderer& operator=(const Renderer&) = delete;
+        Renderer& operator=(Renderer&&) = delete;
+        ~Renderer();
 
-        void beginFrame(const glm::mat4& viewMatrix) noexcept;
+        void beginFrame(const glm::mat4& viewMatrix, const Time& time = Time{}) noexcept;
         void endFrame() noexcept;
         void drawQuad(const glm::vec3& translation,
                       float rotationAngle,
@@ -53,38 +91,101 @@
                       const Texture& texture,
                       const Rect& textureRect = Rect::unit(),
                       const Color& color = Color::white()) noexcept;
+        // Draws every particle as a quad. The vertices are written directly into the upload buffer without
+        // creating render commands, so pending commands are flushed first to keep the drawing order.
+        void drawParticles(const ParticleSystem& particleSystem, ShaderProgram& shader, const Texture& texture) noexcept;
+        // Queues a command list (e.g. recorded on a worker thread) for the current frame. The list is merged
+        // into the command buffer at endFrame(), so it must neither be modified nor destroyed before that.
+        void submit(const RenderCommandList& commandList);
         [[nodiscard]] const RenderStats& stats() const {
             return mRenderStats;
         }
+        // the stats are only updated for frames that were ended
+        [[nodiscard]] std::uint64_t numEndedFrames() const noexcept {
+            return mNumEndedFrames;
+        }
+        [[nodiscard]] VertexFormat vertexFormat() const noexcept {
+            return mVertexFormat;
+        }
+        [[nodiscard]] SubmissionMode submissionMode() const noexcept {
+            return mSubmissionMode;
+        }
+        // Renders the scene into an offscreen target of the given size which is then upscaled to the window by the
+        // largest integer factor that fits (nearest filtering). std::nullopt renders at window resolution.
+        void setVirtualResolution(std::optional<glm::ivec2> resolution) noexcept;
+        [[nodiscard]] std::optional<glm::ivec2> virtualResolution() const noexcept {
+            return mVirtualResolution;
+        }
+        // Converts a position in window coordinates (origin in the center, see Input::mousePosition()) to pixel
+        // coordinates of the virtual resolution (or the window if there is none), origin in the bottom left corner.
+        [[nodiscard]] glm::vec2 toVirtualPosition(glm::vec2 windowPosition) const noexcept;
+        [[nodiscard]] RenderTargetPool& renderTargetPool() noexcept {
+            return mRenderTargetPool;
+        }
         static void clear(bool colorBuffer, bool depthBuffer) noexcept;
         static void setClearColor(const Color& color) noexcept;
 
     private:
-        struct RenderCommand {
-            glm::mat4 transformMatrix;
-            Rect textureRect;
-            Color color;
+        struct IndirectBatch {
             ShaderProgram* shader;
-            const Texture* texture;
+            std::size_t firstTextureName;
+            std::size_t numTextureNames;
         };
 
     private:
+        void appendCommands(std::span<const RenderCommand> commands) noexcept;
         void flushCommandBuffer() noexcept;
+        void useShader(const ShaderProgram& shader) const noexcept;
         void flushVertexAndIndexData() noexcept;
         void addVertexAndIndexDataFromRenderCommand(const RenderCommand& renderCommand);
+        void addQuadIndexData(std::size_t numQuads) noexcept;
+        void recordIndirectBatch();
+        [[nodiscard]] static int upscaleFactor(WindowSize windowSize, glm::ivec2 virtualSize) noexcept;
+        void submitIndirectBatches() noexcept;
+        void upscaleToWindow() noexcept;
+        void reserveVertexAndIndexData(std::size_t numVertices, std::size_t numIndexData);
+        [[nodiscard]] std::span<GLuint const> textureNamesOf(const IndirectBatch& batch) const noexcept {
+            return std::span{ mIndirectTextureNames }.subspan(batch.firstTextureName, batch.numTextureNames);
+        }
+        template<typename Vertex>
+        [[nodiscard]] Vertex* nextVertices() noexcept {
+            return reinterpret_cast<Vertex*>(mVertexData.data()) + mNumVertices;
+        }
 
     private:
         static constexpr std::size_t maxCommandsPerBatch = 20'000;
+        static constexpr std::size_t maxVerticesPerBatch = maxCommandsPerBatch * 4ULL;
         std::uint64_t mNumTrianglesInCurrentBatch = 0ULL;
+        VertexFormat mVertexFormat;
+        std::size_t mVertexSize;
+        SubmissionMode mSubmissionMode;
         std::vector<RenderCommand> mCommandBuffer;
-        std::vector<VertexData> mVertexData;
+        std::vector<std::byte> mVertexData;
+        std::size_t mNumVertices{ 0U };
         std::vector<IndexData> mIndexData;
+        std::size_t mNumIndexData{ 0U };
+        std::size_t mBatchFirstVertex{ 0U };
+        std::size_t mBatchFirstIndexData{ 0U };
         decltype(mCommandBuffer)::iterator mCommandIterator;
-        decltype(mVertexData)::iterator mVertexIterator;
-        decltype(mIndexData)::iterator mIndexIterator;
+        std::vector<const RenderCommandList*> mSubmittedCommandLists;
         VertexBuffer mVertexBuffer;
+        ShaderProgram* mCurrentShader{ nullptr };
+        std::vector<IndirectBatch> mIndirectBatches;
+        std::vector<GLuint> mIndirectTextureNames;
+        std::vector<DrawElementsIndirectCommand> mIndirectCommands;
+        std::vector<DrawMetadata> mDrawMetadata;
+        IndirectDrawBuffer mIndirectDrawBuffer;
+        UniformBuffer mFrameUniformBuffer;
+        std::optional<glm::ivec2> mVirtualResolution;
+        RenderTargetPool mRenderTargetPool;
+        RenderTarget* mCurrentRenderTarget{ nullptr };
+        ShaderProgram mUpscaleProgram;
+        // attributeless drawing of the fullscreen triangle still requires a bound vertex array
+        GLuint mEmptyVertexArrayName{ 0U };
         RenderStats mRenderStats;
+        std::uint64_t mNumEndedFrames{ 0ULL };
         std::vector<GLuint> mCurrentTextureNames;
+        std::size_t mCurrentTextureCapacity{ 0U };
         GLuint mCurrentShaderProgramName{ 0U };
         glm::mat4 mCurrentViewProjectionMatrix{ 0.0f };
         const Window& mWindow;
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Fixed capacity FIFO buffer for a single thread. When the buffer is full, pushing overwrites the oldest element,
+// so it never allocates and always keeps the most recent elements.
+template<typename T, std::size_t Capacity>
+class RingBuffer final {
+    static_assert(std::has_single_bit(Capacity), "the capacity has to be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    class ConstIterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T const*;
+        using reference = T const&;
+
+        ConstIterator() noexcept = default;
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return (*mBuffer)[mIndex];
+        }
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &(*mBuffer)[mIndex];
+        }
+        ConstIterator& operator++() noexcept {
+            ++mIndex;
+            return *this;
+        }
+        ConstIterator operator++(int) noexcept {
+            auto result = *this;
+            ++mIndex;
+            return result;
+        }
+        [[nodiscard]] bool operator==(ConstIterator const& other) const noexcept {
+            return mIndex == other.mIndex;
+        }
+
+    private:
+        ConstIterator(RingBuffer const* const buffer, std::size_t const index) noexcept
+            : mBuffer{ buffer },
+              mIndex{ index } { }
+
+    private:
+        RingBuffer const* mBuffer{ nullptr };
+        std::size_t mIndex{ 0 };
+
+        friend class RingBuffer;
+    };
+
+public:
+    // returns false if the oldest element had to be overwritten
+    bool push(T const& value) noexcept {
+        auto const hasSpace = mSize < Capacity;
+        mSlots[(mFirst + mSize) & (Capacity - 1)] = value;
+        if (hasSpace) {
+            ++mSize;
+        } else {
+            mFirst = (mFirst + 1) & (Capacity - 1);
+        }
+        return hasSpace;
+    }
+
+    void clear() noexcept {
+        mFirst = 0;
+        mSize = 0;
+    }
+
+    // index 0 is the oldest element
+    [[nodiscard]] T const& operator[](std::size_t const index) const noexcept {
+        return mSlots[(mFirst + index) & (Capacity - 1)];
+    }
+    [[nodiscard]] T const& back() const noexcept {
+        return (*this)[mSize - 1];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mSize;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return mSize == 0;
+    }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    [[nodiscard]] ConstIterator begin() const noexcept {
+        return ConstIterator{ this, 0 };
+    }
+    [[nodiscard]] ConstIterator end() const noexcept {
+        return ConstIterator{ this, mSize };
+    }
+
+private:
+    std::array<T, Capacity> mSlots{};
+    std::size_t mFirst{ 0 };
+    std::size_t mSize{ 0 };
+};
@@ -1,60 +1,249 @@
 #include "scoped_timer.hpp"
+#include <algorithm>
+#include <deque>
 #include <filesystem>
+#include <gsl/gsl>
+#include <limits>
+#include <mutex>
 #include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
 
-ScopedTimer::ScopedTimer(char const* name, std::source_location sourceLocation) noexcept
-    : mName(name),
-      mSourceLocation{ sourceLocation },
-      startTime{ std::chrono::high_resolution_clock::now() } {
-    ++sCurrentDepth;
-}
+namespace {
+    using Event = ScopedTimer::Event;
+    using Measurement = ScopedTimer::Measurement;
+    using Zone = ScopedTimer::Zone;
 
-ScopedTimer::~ScopedTimer() {
-    auto endTime = std::chrono::high_resolution_clock::now();
-    --sCurrentDepth;
-    auto duration = std::chrono::duration<double>(endTime - startTime).count();
-    auto locationString = sourceLocationToString(mName, mSourceLocation);
-    auto findIt = sMeasurements.find(locationString);
-    if (findIt == sMeasurements.end()) { // not found in map
-        sMeasurements[locationString] = Measurement{ .count = 1,
-                                                     .depth = sCurrentDepth,
-                                                     .minDuration = duration,
-                                                     .maxDuration = duration,
-                                                     .totalDuration = duration };
-    } else {
-        Measurement& measurement = findIt->second;
-        ++measurement.count;
-        measurement.minDuration = std::min(measurement.minDuration, duration);
-        measurement.maxDuration = std::max(measurement.maxDuration, duration);
-        measurement.totalDuration += duration;
+    constexpr std::size_t eventBufferSize = 4096;
+
+    void accumulate(std::vector<Measurement>& measurements, std::size_t const zone, Measurement const& measurement) {
+        if (zone >= measurements.size()) {
+            measurements.resize(zone + 1, Measurement{ .count = 0,
+                                                       .depth = 0,
+                                                       .minDuration = std::numeric_limits<double>::max(),
+                                                       .maxDuration = 0.0,
+                                                       .totalDuration = 0.0,
+                                                       .numAllocations = 0,
+                                                       .numAllocatedBytes = 0 });
+        }
+        auto& target = measurements[zone];
+        if (target.count == 0) {
+            target.depth = measurement.depth;
+        }
+        target.count += measurement.count;
+        target.minDuration = std::min(target.minDuration, measurement.minDuration);
+        target.maxDuration = std::max(target.maxDuration, measurement.maxDuration);
+        target.totalDuration += measurement.totalDuration;
+        target.numAllocations += measurement.numAllocations;
+        target.numAllocatedBytes += measurement.numAllocatedBytes;
+    }
+
+    struct ThreadData;
+
+    struct Registry {
+        std::mutex mutex;
+        // a deque never moves its elements
+        std::deque<Zone> zones;
+        std::vector<ThreadData*> threads;
+        // results of threads that already exited
+        std::vector<Measurement> retiredMeasurements;
+        std::vector<ScopedTimer::ThreadTrace> retiredTraces;
+        std::uint32_t nextThreadId{ 1 };
+    };
+
+    [[nodiscard]] Registry& registry() {
+        static Registry instance;
+        return instance;
     }
-}
 
-std::string
-ScopedTimer::sourceLocationToString(std::string const& name, std::source_location const& sourceLocation) noexcept {
-    auto path = std::filesystem::path(sourceLocation.file_name());
-    if (name.empty()) {
+    struct ThreadData {
+        std::vector<Event> events;
+        std::uint32_t depth{ 0 };
+        std::vector<Measurement> measurements;
+        std::uint32_t threadId{ 0 };
+        // guards the members below, they are taken by other threads
+        std::mutex traceMutex;
+        std::string threadName;
+        std::vector<Event> traceEvents;
+        std::uint64_t numDroppedTraceEvents{ 0 };
+
+        ThreadData() {
+            events.reserve(eventBufferSize);
+            auto& reg = registry();
+            auto const lock = std::scoped_lock{ reg.mutex };
+            threadId = reg.nextThreadId++;
+            threadName = fmt::format("thread {}", threadId);
+            reg.threads.push_back(this);
+        }
+
+        ThreadData(ThreadData const&) = delete;
+        ThreadData(ThreadData&&) = delete;
+        ThreadData& operator=(ThreadData const&) = delete;
+        ThreadData& operator=(ThreadData&&) = delete;
+
+        ~ThreadData() {
+            flush();
+            auto& reg = registry();
+            auto const lock = std::scoped_lock{ reg.mutex };
+            std::erase(reg.threads, this);
+            if (!traceEvents.empty()) {
+                reg.retiredTraces.push_back(ScopedTimer::ThreadTrace{ .threadId{ threadId },
+                                                                      .threadName{ std::move(threadName) },
+                                                                      .events{ std::move(traceEvents) },
+                                                                      .numDroppedEvents{ numDroppedTraceEvents } });
+            }
+            for (std::size_t zone = 0; zone < measurements.size(); ++zone) {
+                if (measurements[zone].count > 0) {
+                    accumulate(reg.retiredMeasurements, zone, measurements[zone]);
+                }
+            }
+        }
+
+        // only called by the owning thread (or when it's known to be idle)
+        void flush() noexcept {
+            for (auto const& event : events) {
+                auto const duration = static_cast<double>(event.endTime - event.beginTime) / 1'000'000'000.0;
+                accumulate(
+                        measurements,
+                        event.zone,
+                        Measurement{ .count = 1,
+                                     .depth = event.depth,
+                                     .minDuration = duration,
+                                     .maxDuration = duration,
+                                     .totalDuration = duration,
+                                     .numAllocations = event.numAllocations,
+                                     .numAllocatedBytes = event.numAllocatedBytes }
+                );
+            }
+            events.clear();
+        }
+    };
+
+    thread_local ThreadData tThreadData;
+
+    [[nodiscard]] std::string zoneLabel(Zone const& zone) {
+        auto const filename = std::filesystem::path(zone.sourceLocation.file_name()).filename().string();
         return fmt::format(
                 "[{}, {}]{}",
-                path.filename().string(),
-                sourceLocation.line(),
-                sourceLocation.function_name()
+                filename,
+                zone.sourceLocation.line(),
+                *zone.name == '\0' ? zone.sourceLocation.function_name() : zone.name
         );
     }
-    return fmt::format("[{}, {}]{}", path.filename().string(), sourceLocation.line(), name);
+} // namespace
+
+ScopedTimer::ScopedTimer(ZoneId const zone) noexcept : mZone{ zone } {
+    ++tThreadData.depth;
+    if constexpr (AllocationTracker::isEnabled()) {
+        mBeginAllocations = AllocationTracker::threadCounts();
+    }
+    mBeginTime = now();
+}
+
+ScopedTimer::~ScopedTimer() {
+    auto const endTime = now();
+    auto const allocations = AllocationTracker::isEnabled() ? AllocationTracker::threadCounts() - mBeginAllocations
+                                                            : AllocationCounts{};
+    auto& threadData = tThreadData;
+    --threadData.depth;
+    if (threadData.events.size() == eventBufferSize) {
+        threadData.flush();
+    }
+    auto const event = Event{ .zone{ mZone },
+                              .depth{ threadData.depth },
+                              .beginTime{ mBeginTime },
+                              .endTime{ endTime },
+                              .numAllocations{ allocations.numAllocations },
+                              .numAllocatedBytes{ allocations.numAllocatedBytes } };
+    threadData.events.push_back(event);
+    if (sIsTracingEnabled.load(std::memory_order_relaxed)) {
+        auto const lock = std::scoped_lock{ threadData.traceMutex };
+        if (threadData.traceEvents.size() < maxTraceEventsPerThread) {
+            threadData.traceEvents.push_back(event);
+        } else {
+            ++threadData.numDroppedTraceEvents;
+        }
+    }
+}
+
+ScopedTimer::ZoneId ScopedTimer::registerZone(char const* const name, std::source_location const sourceLocation) {
+    auto& reg = registry();
+    auto const lock = std::scoped_lock{ reg.mutex };
+    reg.zones.push_back(Zone{ .name{ name }, .sourceLocation{ sourceLocation } });
+    return gsl::narrow_cast<ZoneId>(reg.zones.size() - 1);
+}
+
+void ScopedTimer::setThreadName(std::string name) {
+    auto& threadData = tThreadData;
+    auto const lock = std::scoped_lock{ threadData.traceMutex };
+    threadData.threadName = std::move(name);
+}
+
+ScopedTimer::Zone ScopedTimer::zone(ZoneId const id) {
+    auto& reg = registry();
+    auto const lock = std::scoped_lock{ reg.mutex };
+    return reg.zones.at(id);
+}
+
+std::vector<ScopedTimer::ThreadTrace> ScopedTimer::takeTraceEvents() {
+    auto& reg = registry();
+    auto const lock = std::scoped_lock{ reg.mutex };
+    auto result = std::move(reg.retiredTraces);
+    reg.retiredTraces.clear();
+    for (auto const thread : reg.threads) {
+        auto const traceLock = std::scoped_lock{ thread->traceMutex };
+        if (!thread->traceEvents.empty()) {
+            result.push_back(ThreadTrace{ .threadId{ thread->threadId },
+                                          .threadName{ thread->threadName },
+                                          .events{ std::move(thread->traceEvents) },
+                                          .numDroppedEvents{ thread->numDroppedTraceEvents } });
+            thread->traceEvents.clear();
+            thread->numDroppedTraceEvents = 0;
+        }
+    }
+    return result;
 }
 
 void ScopedTimer::logResults() noexcept {
 #if ENABLE_PROFILING
+    auto& reg = registry();
+    auto const lock = std::scoped_lock{ reg.mutex };
+    auto totals = reg.retiredMeasurements;
+    for (auto const thread : reg.threads) {
+        thread->flush();
+        for (std::size_t zone = 0; zone < thread->measurements.size(); ++zone) {
+            if (thread->measurements[zone].count > 0) {
+                accumulate(totals, zone, thread->measurements[zone]);
+            }
+        }
+    }
     std::vector<std::pair<std::string, Measurement>> measurements;
-    for (auto const& dataPoint : sMeasurements) {
-        measurements.emplace_back(dataPoint);
+    for (std::size_t zone = 0; zone < totals.size(); ++zone) {
+        if (totals[zone].count > 0) {
+            measurements.emplace_back(zoneLabel(reg.zones[zone]), totals[zone]);
+        }
     }
     std::sort(measurements.begin(), measurements.end(), [](auto const& lhs, auto const& rhs) {
         return lhs.second.totalDuration > rhs.second.totalDuration;
     });
     spdlog::info("=== Measurement Summary (all times in ms) ===");
     for (auto const& dataPoint : measurements) {
+        if constexpr (AllocationTracker::isEnabled()) {
+            spdlog::info(
+                    "{:->{}}{}|{:.3f} ({}x)|AVG:{:.3f}|MIN: {:.3f}|MAX: {:.3f}|ALLOC: {} ({} bytes)",
+                    "",
+                    dataPoint.second.depth,
+                    dataPoint.first,
+                    dataPoint.second.totalDuration * 1000.0,
+                    dataPoint.second.count,
+                    dataPoint.second.totalDuration * 1000.0 / gsl::narrow_cast<double>(dataPoint.second.count),
+                    dataPoint.second.minDuration * 1000.0,
+                    dataPoint.second.maxDuration * 1000.0,
+                    dataPoint.second.numAllocations,
+                    dataPoint.second.numAllocatedBytes
+            );
+            continue;
+        }
         spdlog::info(
                 "{:->{}}{}|{:.3f} ({}x)|AVG:{:.3f}|MIN: {:.3f}|MAX: {:.3f}",
                 "",
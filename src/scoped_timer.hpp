@@ -5,13 +5,18 @@
 #endif
 
 #if ENABLE_PROFILING
-#define SCOPED_TIMER_LINE2(line) \
-    ScopedTimer _scoped_Timer##line { }
+// every call site registers its zone exactly once
+#define SCOPED_TIMER_LINE2(line)                                                      \
+    static ScopedTimer::ZoneId const _scoped_timer_zone##line = ScopedTimer::registerZone(); \
+    ScopedTimer _scoped_Timer##line {                                                 \
+        _scoped_timer_zone##line                                                      \
+    }
 #define SCOPED_TIMER_LINE(line) SCOPED_TIMER_LINE2(line)
 #define SCOPED_TIMER() SCOPED_TIMER_LINE(__LINE__)
-#define SCOPED_TIMER_NAMED_LINE2(name, line) \
-    ScopedTimer _scoped_Timer##line {        \
-        name                                 \
+#define SCOPED_TIMER_NAMED_LINE2(name, line)                                              \
+    static ScopedTimer::ZoneId const _scoped_timer_zone##line = ScopedTimer::registerZone(name); \
+    ScopedTimer _scoped_Timer##line {                                                     \
+        _scoped_timer_zone##line                                                          \
     }
 #define SCOPED_TIMER_NAMED_LINE(name, line) SCOPED_TIMER_NAMED_LINE2(name, line)
 #define SCOPED_TIMER_NAMED(name) SCOPED_TIMER_NAMED_LINE(name, __LINE__)
@@ -20,36 +25,92 @@
 #define SCOPED_TIMER_NAMED(name)
 #endif
 
+#include "allocation_tracker.hpp"
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <source_location>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
-class ScopedTimer {
+// Measures the CPU time spent inside of a scope. The hot path only reads the clock twice and appends an event
+// to a buffer of the current thread; the events are aggregated per zone (= call site) when a buffer is full
+// or when the results are logged.
+class ScopedTimer final {
 public:
+    using ZoneId = std::uint32_t;
+
     struct Measurement {
         std::uint64_t count;
         std::uint64_t depth;
         double minDuration;
         double maxDuration;
         double totalDuration;
+        // only counted with ENABLE_ALLOCATION_TRACKING, including nested zones
+        std::uint64_t numAllocations;
+        std::uint64_t numAllocatedBytes;
+    };
+
+    struct Zone {
+        char const* name;
+        std::source_location sourceLocation;
+    };
+
+    // times in nanoseconds of the steady clock
+    struct Event {
+        ZoneId zone;
+        std::uint32_t depth;
+        std::int64_t beginTime;
+        std::int64_t endTime;
+        std::uint64_t numAllocations;
+        std::uint64_t numAllocatedBytes;
+    };
+
+    struct ThreadTrace {
+        std::uint32_t threadId;
+        std::string threadName;
+        std::vector<Event> events;
+        // events that did not fit into the trace buffer of the thread
+        std::uint64_t numDroppedEvents;
     };
 
 public:
-    explicit
-    ScopedTimer(char const* name = "", std::source_location sourceLocation = std::source_location::current()) noexcept;
+    explicit ScopedTimer(ZoneId zone) noexcept;
+    ScopedTimer(ScopedTimer const&) = delete;
+    ScopedTimer(ScopedTimer&&) = delete;
+    ScopedTimer& operator=(ScopedTimer const&) = delete;
+    ScopedTimer& operator=(ScopedTimer&&) = delete;
     ~ScopedTimer();
+
+    // thread-safe, but takes a lock: the result has to be stored (the macros use a static variable)
+    [[nodiscard]] static ZoneId
+    registerZone(char const* name = "", std::source_location sourceLocation = std::source_location::current());
+    // has to be called while no other thread is measuring (e.g. at shutdown)
     static void logResults() noexcept;
+    // shown in traces instead of the thread id
+    static void setThreadName(std::string name);
+    [[nodiscard]] static Zone zone(ZoneId id);
 
-private:
-    static std::string
-    sourceLocationToString(std::string const& name, std::source_location const& sourceLocation) noexcept;
+    // While tracing is enabled, every event is additionally stored until it is taken by takeTraceEvents().
+    // This takes an uncontended lock per event, so it's only meant to be enabled for captures. Each thread stores
+    // at most maxTraceEventsPerThread events, later events are dropped.
+    static void setTracingEnabled(bool enabled) noexcept {
+        sIsTracingEnabled.store(enabled, std::memory_order_relaxed);
+    }
+    [[nodiscard]] static std::vector<ThreadTrace> takeTraceEvents();
+    static constexpr std::size_t maxTraceEventsPerThread = std::size_t{ 1 } << 20;
+
+    [[nodiscard]] static std::int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()
+        )
+                .count();
+    }
 
 private:
-    std::string mName;
-    std::source_location mSourceLocation;
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-    static inline uint64_t sCurrentDepth{ 0ULL };
-    static inline std::unordered_map<std::string, Measurement> sMeasurements{};
+    ZoneId mZone;
+    std::int64_t mBeginTime;
+    AllocationCounts mBeginAllocations;
+    static inline std::atomic_bool sIsTracingEnabled{ false };
 };
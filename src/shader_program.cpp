@@ -1,87 +1,225 @@
 #include "shader_program.hpp"
+#include "gl_state_cache.hpp"
 #include "hash/hash.hpp"
+#include "program_binary_cache.hpp"
+#include <GLFW/glfw3.h>
 #include <cassert>
 #include <fstream>
 #include <spdlog/spdlog.h>
 
-GLuint ShaderProgram::sCurrentlyBoundName{ 0U };
-
 ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept {
     using std::swap;
     swap(mName, other.mName);
-    swap(mUniformLocations, other.mUniformLocations);
+    swap(mUniforms, other.mUniforms);
+    swap(mProjectionMatrixUniform, other.mProjectionMatrixUniform);
+    swap(mTextureArraySize, other.mTextureArraySize);
+    swap(mPendingVertexShaderName, other.mPendingVertexShaderName);
+    swap(mPendingFragmentShaderName, other.mPendingFragmentShaderName);
+    swap(mCacheKey, other.mCacheKey);
 }
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
     using std::swap;
     swap(mName, other.mName);
-    swap(mUniformLocations, other.mUniformLocations);
+    swap(mUniforms, other.mUniforms);
+    swap(mProjectionMatrixUniform, other.mProjectionMatrixUniform);
+    swap(mTextureArraySize, other.mTextureArraySize);
+    swap(mPendingVertexShaderName, other.mPendingVertexShaderName);
+    swap(mPendingFragmentShaderName, other.mPendingFragmentShaderName);
+    swap(mCacheKey, other.mCacheKey);
     return *this;
 }
 
 ShaderProgram::~ShaderProgram() {
+    deletePendingShaders();
+    GLStateCache::instance().onProgramDeleted(mName);
     glDeleteProgram(mName);
 }
 
+namespace {
+    constexpr GLenum completionStatusKHR = 0x91B1; // GL_COMPLETION_STATUS_KHR
+
+    using MaxShaderCompilerThreadsKHR = void (*)(GLuint count);
+
+    // glad is generated without extensions, so GL_KHR_parallel_shader_compile is loaded manually
+    [[nodiscard]] bool initializeParallelCompilation() noexcept {
+        static bool const isSupported = [] {
+            for (auto const extension : { "GL_KHR_parallel_shader_compile", "GL_ARB_parallel_shader_compile" }) {
+                if (glfwExtensionSupported(extension) == GLFW_TRUE) {
+                    auto const setThreadCount = reinterpret_cast<MaxShaderCompilerThreadsKHR>(
+                            glfwGetProcAddress("glMaxShaderCompilerThreadsKHR")
+                    );
+                    if (setThreadCount != nullptr) {
+                        // 0xFFFFFFFF lets the driver choose the number of threads
+                        setThreadCount(0xFFFF'FFFFU);
+                    }
+                    spdlog::info("Shaders are compiled in parallel ({}).", extension);
+                    return true;
+                }
+            }
+            return false;
+        }();
+        return isSupported;
+    }
+
+    [[nodiscard]] bool checkCompileStatus(GLuint const shaderName, std::string_view const shaderType) noexcept {
+        GLint success = GL_FALSE;
+        glGetShaderiv(shaderName, GL_COMPILE_STATUS, &success);
+        if (success == GL_FALSE) {
+            char infoLog[512];
+            glGetShaderInfoLog(shaderName, sizeof(infoLog), nullptr, infoLog);
+            spdlog::error("Failed to compile {} shader: {}", shaderType, infoLog);
+        }
+        return success != GL_FALSE;
+    }
+} // namespace
+
 bool ShaderProgram::compile(std::string const& vertexShaderSource, std::string const& fragmentShaderSource) noexcept {
-    if (hasBeenCompiled()) {
+    return beginCompile(vertexShaderSource, fragmentShaderSource) && finishCompile();
+}
+
+bool ShaderProgram::beginCompile(
+        std::string const& vertexShaderSource,
+        std::string const& fragmentShaderSource
+) noexcept {
+    if (mName != 0U) {
+        deletePendingShaders();
+        GLStateCache::instance().onProgramDeleted(mName);
         glDeleteProgram(mName);
         mName = 0U;
     }
-    GLuint vertexShaderName = glCreateShader(GL_VERTEX_SHADER);
-    GLchar const* vertexShaderSourcesArray[] = { vertexShaderSource.c_str() };
-    glShaderSource(vertexShaderName, 1U, vertexShaderSourcesArray, nullptr);
-    glCompileShader(vertexShaderName);
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShaderName, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShaderName, sizeof(infoLog), nullptr, infoLog);
-        spdlog::error("Failed to compile vertex shader: {}", infoLog);
-        glDeleteShader(vertexShaderName);
-        return false;
+    mCacheKey = ProgramBinaryCache::key({ vertexShaderSource, fragmentShaderSource });
+    if (auto const cachedProgram = ProgramBinaryCache::load(mCacheKey)) {
+        mName = cachedProgram.value();
+        cacheUniformLocations();
+        spdlog::info("Loaded shader program from the binary cache.");
+        return true;
+    } else {
+        spdlog::debug("Compiling shader program from source ({}).", cachedProgram.error());
     }
+    [[maybe_unused]] bool const isParallel = initializeParallelCompilation();
+
+    // the compile and link status is only queried in finishCompile(), so the driver can work in the background
+    mPendingVertexShaderName = glCreateShader(GL_VERTEX_SHADER);
+    GLchar const* vertexShaderSourcesArray[] = { vertexShaderSource.c_str() };
+    glShaderSource(mPendingVertexShaderName, 1U, vertexShaderSourcesArray, nullptr);
+    glCompileShader(mPendingVertexShaderName);
 
-    GLuint fragmentShaderName = glCreateShader(GL_FRAGMENT_SHADER);
+    mPendingFragmentShaderName = glCreateShader(GL_FRAGMENT_SHADER);
     GLchar const* fragmentShaderSourcesArray[] = { fragmentShaderSource.c_str() };
-    glShaderSource(fragmentShaderName, 1U, fragmentShaderSourcesArray, nullptr);
-    glCompileShader(fragmentShaderName);
-    glGetShaderiv(fragmentShaderName, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShaderName, sizeof(infoLog), nullptr, infoLog);
-        spdlog::error("Failed to compile fragment shader: {}", infoLog);
-        glDeleteShader(vertexShaderName);
-        glDeleteShader(fragmentShaderName);
+    glShaderSource(mPendingFragmentShaderName, 1U, fragmentShaderSourcesArray, nullptr);
+    glCompileShader(mPendingFragmentShaderName);
+
+    this->mName = glCreateProgram();
+    glAttachShader(this->mName, mPendingVertexShaderName);
+    glAttachShader(this->mName, mPendingFragmentShaderName);
+    glProgramParameteri(this->mName, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(this->mName);
+    return true;
+}
+
+bool ShaderProgram::compileCompute(std::string const& computeShaderSource) noexcept {
+    if (mName != 0U) {
+        deletePendingShaders();
+        GLStateCache::instance().onProgramDeleted(mName);
+        glDeleteProgram(mName);
+        mName = 0U;
+    }
+    mCacheKey = ProgramBinaryCache::key({ computeShaderSource });
+    if (auto const cachedProgram = ProgramBinaryCache::load(mCacheKey)) {
+        mName = cachedProgram.value();
+        cacheUniformLocations();
+        spdlog::info("Loaded compute shader program from the binary cache.");
+        return true;
+    }
+
+    auto const computeShaderName = glCreateShader(GL_COMPUTE_SHADER);
+    GLchar const* computeShaderSourcesArray[] = { computeShaderSource.c_str() };
+    glShaderSource(computeShaderName, 1U, computeShaderSourcesArray, nullptr);
+    glCompileShader(computeShaderName);
+    if (!checkCompileStatus(computeShaderName, "compute")) {
+        glDeleteShader(computeShaderName);
         return false;
     }
 
     this->mName = glCreateProgram();
-    glAttachShader(this->mName, vertexShaderName);
-    glAttachShader(this->mName, fragmentShaderName);
+    glAttachShader(this->mName, computeShaderName);
+    glProgramParameteri(this->mName, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(this->mName);
+    glDeleteShader(computeShaderName);
 
+    GLint success = GL_FALSE;
     glGetProgramiv(this->mName, GL_LINK_STATUS, &success);
-    if (!success) {
+    if (success == GL_FALSE) {
+        char infoLog[512];
         glGetProgramInfoLog(this->mName, sizeof(infoLog), nullptr, infoLog);
-        spdlog::error("Failed to link shader program: {}", infoLog);
-        glDeleteShader(vertexShaderName);
-        glDeleteShader(fragmentShaderName);
+        spdlog::error("Failed to link compute shader program: {}", infoLog);
+        glDeleteProgram(this->mName);
+        this->mName = 0U;
+        return false;
+    }
+    cacheUniformLocations();
+    ProgramBinaryCache::store(mCacheKey, mName);
+    spdlog::info("Successfully linked compute shader program.");
+    return true;
+}
+
+bool ShaderProgram::isCompilationPending() const noexcept {
+    return mPendingVertexShaderName != 0U;
+}
+
+bool ShaderProgram::isCompilationComplete() const noexcept {
+    if (!isCompilationPending()) {
+        return true;
+    }
+    if (!initializeParallelCompilation()) {
+        // without the extension the status query blocks anyway
+        return true;
+    }
+    GLint completed = GL_FALSE;
+    glGetProgramiv(mName, completionStatusKHR, &completed);
+    return completed != GL_FALSE;
+}
+
+bool ShaderProgram::finishCompile() noexcept {
+    if (!isCompilationPending()) {
+        return hasBeenCompiled();
+    }
+    bool const compiled = checkCompileStatus(mPendingVertexShaderName, "vertex")
+                          && checkCompileStatus(mPendingFragmentShaderName, "fragment");
+    deletePendingShaders();
+
+    GLint success = GL_FALSE;
+    if (compiled) {
+        glGetProgramiv(this->mName, GL_LINK_STATUS, &success);
+        if (success == GL_FALSE) {
+            char infoLog[512];
+            glGetProgramInfoLog(this->mName, sizeof(infoLog), nullptr, infoLog);
+            spdlog::error("Failed to link shader program: {}", infoLog);
+        }
+    }
+    if (success == GL_FALSE) {
         glDeleteProgram(this->mName);
+        this->mName = 0U;
         return false;
     }
 
-    glDeleteShader(vertexShaderName);
-    glDeleteShader(fragmentShaderName);
     cacheUniformLocations();
+    ProgramBinaryCache::store(mCacheKey, mName);
     spdlog::info("Successfully linked shader program.");
     return true;
 }
 
+void ShaderProgram::deletePendingShaders() noexcept {
+    // deleting attached shaders only flags them, they are deleted together with the program
+    glDeleteShader(mPendingVertexShaderName);
+    glDeleteShader(mPendingFragmentShaderName);
+    mPendingVertexShaderName = 0U;
+    mPendingFragmentShaderName = 0U;
+}
+
 void ShaderProgram::bind(GLuint shaderName) noexcept {
-    if (sCurrentlyBoundName != shaderName) {
-        glUseProgram(shaderName);
-        sCurrentlyBoundName = shaderName;
-    }
+    GLStateCache::instance().useProgram(shaderName);
 }
 
 void ShaderProgram::bind() const noexcept {
@@ -123,10 +261,9 @@ tl::expected<ShaderProgram, std::string> ShaderProgram::generateFromFiles(
 }
 
 void ShaderProgram::setUniform(std::size_t uniformNameHash, glm::mat4 const& matrix) const noexcept {
-    bind();
-    auto const it = mUniformLocations.find(uniformNameHash);
+    auto const it = mUniforms.find(uniformNameHash);
 
-    if (it == mUniformLocations.cend()) {
+    if (it == mUniforms.cend()) {
 #ifdef DEBUG_BUILD
         spdlog::error(
                 "Could not set uniform \"{}\" since it could not be found.",
@@ -137,10 +274,29 @@ void ShaderProgram::setUniform(std::size_t uniformNameHash, glm::mat4 const& mat
 #endif
         return;
     }
-    glUniformMatrix4fv(it->second, 1, false, glm::value_ptr(matrix));
+    glProgramUniformMatrix4fv(mName, it->second.location, 1, false, glm::value_ptr(matrix));
+}
+
+bool ShaderProgram::bindUniformBlock(std::string_view const blockName, GLuint const bindingPoint) const noexcept {
+    auto const blockIndex = glGetUniformBlockIndex(mName, std::string{ blockName }.c_str());
+    if (blockIndex == GL_INVALID_INDEX) {
+        spdlog::error("Could not bind uniform block \"{}\" since it could not be found.", blockName);
+        return false;
+    }
+    glUniformBlockBinding(mName, blockIndex, bindingPoint);
+    return true;
+}
+
+tl::expected<ShaderProgram::UniformInfo, std::string> ShaderProgram::findUniform(std::string_view const name) const {
+    auto const it = mUniforms.find(hash::hashString(name));
+    if (it == mUniforms.cend()) {
+        return tl::unexpected{ fmt::format("Uniform \"{}\" could not be found.", name) };
+    }
+    return it->second;
 }
 
 void ShaderProgram::cacheUniformLocations() noexcept {
+    mUniforms.clear();
     GLint uniform_count = 0;
     glGetProgramiv(this->mName, GL_ACTIVE_UNIFORMS, &uniform_count);
 
@@ -157,19 +313,31 @@ void ShaderProgram::cacheUniformLocations() noexcept {
             glGetActiveUniform(this->mName, i, max_name_len, &length, &count, &type, uniform_name.get());
 
             GLint location = glGetUniformLocation(this->mName, uniform_name.get());
+            if (location < 0) {
+                // members of uniform blocks don't have a location
+                continue;
+            }
 
-            std::size_t const hash =
-                    hash::hashString(std::string_view{ uniform_name.get(), static_cast<std::size_t>(length) });
-            mUniformLocations[hash] = location;
+            auto name = std::string_view{ uniform_name.get(), static_cast<std::size_t>(length) };
+            auto const info = UniformInfo{ .location{ location }, .type{ type }, .arraySize{ count } };
+            mUniforms[hash::hashString(name)] = info;
+            // arrays are reported as "name[0]", but should also be found by their plain name
+            if (name.ends_with("[0]")) {
+                name.remove_suffix(3);
+                mUniforms[hash::hashString(name)] = info;
+            }
 #ifdef DEBUG_BUILD
-            spdlog::info("uniform location for \"{}\" (hash: {:X}): {}", uniform_name.get(), hash, location);
+            spdlog::info("uniform location for \"{}\": {}", name, location);
 #endif
         }
     }
+    mProjectionMatrixUniform = uniformHandle<glm::mat4>("projectionMatrix").value_or(UniformHandle<glm::mat4>{});
+    auto const textures = findUniform("uTextures");
+    mTextureArraySize = textures ? static_cast<std::size_t>(textures->arraySize) : maxTextureArraySize;
 }
 
-ShaderProgram ShaderProgram::defaultProgram() noexcept {
-    std::string const vertexShader = R"(#version 450 core
+std::string const& ShaderProgram::defaultVertexShaderSource() noexcept {
+    static std::string const source = R"(#version 450 core
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec4 aColor;
@@ -181,7 +349,11 @@ out vec3 fragmentPosition;
 out vec2 texCoords;
 flat out uint texIndex;
 
-uniform mat4 projectionMatrix;
+layout (std140, binding = 0) uniform FrameData {
+    mat4 projectionMatrix;
+    float time;
+    float deltaTime;
+};
 
 void main() {
    vec4 position = projectionMatrix * vec4(aPos.xyz, 1.0);
@@ -191,7 +363,22 @@ void main() {
    texIndex = aTexIndex;
    gl_Position = position;
 })";
-    std::string const fragmentShader = R"(#version 450 core
+    return source;
+}
+
+std::string const& ShaderProgram::defaultFragmentShaderSource() noexcept {
+    // specialized by ShaderVariantCache via TEXTURE_COUNT, ALPHA_DISCARD and PALETTE_LOOKUP
+    static std::string const source = R"(#version 450 core
+
+#ifndef TEXTURE_COUNT
+#define TEXTURE_COUNT 32
+#endif
+#ifndef ALPHA_DISCARD
+#define ALPHA_DISCARD 1
+#endif
+#ifndef PALETTE_LOOKUP
+#define PALETTE_LOOKUP 0
+#endif
 
 in vec3 fragmentPosition;
 in vec4 fragmentColor;
@@ -200,17 +387,35 @@ flat in uint texIndex;
 
 out vec4 FragColor;
 
-layout (binding = 0) uniform sampler2D uTextures[32];
+layout (binding = 0) uniform sampler2D uTextures[TEXTURE_COUNT];
+#if PALETTE_LOOKUP
+// the red channel of the texture is used as index into the palette (bound after the textures)
+layout (binding = TEXTURE_COUNT) uniform sampler2D uPalette;
+#endif
 
 void main() {
-    vec4 color = texture(uTextures[texIndex], texCoords) * fragmentColor;
+#if TEXTURE_COUNT == 1
+    vec4 color = texture(uTextures[0], texCoords);
+#else
+    vec4 color = texture(uTextures[texIndex], texCoords);
+#endif
+#if PALETTE_LOOKUP
+    color = texture(uPalette, vec2(color.r, 0.5));
+#endif
+    color *= fragmentColor;
+#if ALPHA_DISCARD
     if (color.a == 0.0) {
         discard;
     }
+#endif
     FragColor = color;
 })";
+    return source;
+}
+
+ShaderProgram ShaderProgram::defaultProgram() noexcept {
     ShaderProgram result;
-    [[maybe_unused]] bool const success = result.compile(vertexShader, fragmentShader);
+    [[maybe_unused]] bool const success = result.compile(defaultVertexShaderSource(), defaultFragmentShaderSource());
     assert(success);
     return result;
 }
@@ -1,13 +1,29 @@
 #pragma once
 
+#include "flat_hash_map.hpp"
 #include "include_glm.hpp"
+#include "uniform_handle.hpp"
+#include <cstdint>
 #include <glad/gl.h>
-#include <unordered_map>
+#include <span>
+#include <spdlog/spdlog.h>
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <tl/expected.hpp>
 
 class ShaderProgram final {
+public:
+    struct UniformInfo {
+        GLint location;
+        GLenum type;
+        GLint arraySize;
+    };
+
+public:
+    // upper limit of the texture array of the renderer's shaders
+    static constexpr std::size_t maxTextureArraySize = 32;
+
 public:
     ShaderProgram() = default;
     ShaderProgram(ShaderProgram const&) = delete;
@@ -19,26 +35,73 @@ public:
     ~ShaderProgram();
 
     [[nodiscard]] bool compile(std::string const& vertexShaderSource, std::string const& fragmentShaderSource) noexcept;
+    // Starts compiling and linking without waiting for the results, so that the driver can compile several
+    // programs at once (in parallel if GL_KHR_parallel_shader_compile is supported). finishCompile() has to be
+    // called before the program can be used.
+    [[nodiscard]] bool
+    beginCompile(std::string const& vertexShaderSource, std::string const& fragmentShaderSource) noexcept;
+    [[nodiscard]] bool finishCompile() noexcept;
+    [[nodiscard]] bool compileCompute(std::string const& computeShaderSource) noexcept;
+    [[nodiscard]] bool isCompilationPending() const noexcept;
+    // true if finishCompile() would not block
+    [[nodiscard]] bool isCompilationComplete() const noexcept;
     static void bind(GLuint shaderName) noexcept;
     void bind() const noexcept;
     static void unbind() noexcept;
     [[nodiscard]] bool hasBeenCompiled() const noexcept {
-        return mName != 0U;
+        return mName != 0U && !isCompilationPending();
+    }
+    // number of textures the uTextures array of the fragment shader can hold
+    [[nodiscard]] std::size_t textureArraySize() const noexcept {
+        return mTextureArraySize;
     }
     static tl::expected<ShaderProgram, std::string>
     generateFromFiles(std::filesystem::path const& vertexShaderPath, std::filesystem::path const& fragmentShaderPath);
     static void setUniform(GLuint shaderName, std::size_t uniformNameHash, glm::mat4 const& matrix) noexcept;
     void setUniform(std::size_t uniformNameHash, glm::mat4 const& matrix) const noexcept;
+
+    // Resolves the location of a uniform once, so that setting it later on doesn't need any lookup. Fails if the
+    // program has no active uniform of that name or its GLSL type doesn't match T.
+    template<typename T>
+    [[nodiscard]] tl::expected<UniformHandle<T>, std::string> uniformHandle(std::string_view const name) const {
+        auto const info = findUniform(name);
+        if (!info) {
+            return tl::unexpected{ info.error() };
+        }
+        if (!detail::UniformTraits<T>::matches(info->type)) {
+            return tl::unexpected{ fmt::format("Uniform \"{}\" has a different type (0x{:X}).", name, info->type) };
+        }
+        return UniformHandle<T>{ info->location };
+    }
+    template<typename T>
+    void setUniform(UniformHandle<T> const handle, T const& value) const noexcept {
+        detail::UniformTraits<T>::set(mName, handle.location(), 1, &value);
+    }
+    template<typename T>
+    void setUniform(UniformHandle<T> const handle, std::span<T const> const values) const noexcept {
+        detail::UniformTraits<T>::set(mName, handle.location(), static_cast<GLsizei>(values.size()), values.data());
+    }
+    // assigns a uniform block (e.g. per-material parameters) to a uniform buffer binding point
+    [[nodiscard]] bool bindUniformBlock(std::string_view blockName, GLuint bindingPoint) const noexcept;
     [[nodiscard]] static ShaderProgram defaultProgram() noexcept;
+    [[nodiscard]] static std::string const& defaultVertexShaderSource() noexcept;
+    [[nodiscard]] static std::string const& defaultFragmentShaderSource() noexcept;
 
 
 private:
     void cacheUniformLocations() noexcept;
+    void deletePendingShaders() noexcept;
+    [[nodiscard]] tl::expected<UniformInfo, std::string> findUniform(std::string_view name) const;
 
 private:
-    static GLuint sCurrentlyBoundName;
     GLuint mName{ 0U };
-    std::unordered_map<std::size_t, GLint> mUniformLocations;
+    FlatHashMap<std::size_t, UniformInfo> mUniforms;
+    // only present in shaders that don't use the FrameData uniform block
+    UniformHandle<glm::mat4> mProjectionMatrixUniform;
+    std::size_t mTextureArraySize{ maxTextureArraySize };
+    GLuint mPendingVertexShaderName{ 0U };
+    GLuint mPendingFragmentShaderName{ 0U };
+    std::uint64_t mCacheKey{ 0ULL };
 
     friend class Renderer;
 };
@@ -0,0 +1,108 @@
+#include "shader_variant_cache.hpp"
+#include <algorithm>
+#include <gsl/gsl>
+#include <spdlog/spdlog.h>
+
+ShaderVariantCache::ShaderVariantCache(std::string vertexShaderSource, std::string fragmentShaderSource)
+    : mVertexShaderSource{ std::move(vertexShaderSource) },
+      mFragmentShaderSource{ std::move(fragmentShaderSource) } { }
+
+ShaderVariantCache ShaderVariantCache::defaultVariants() {
+    return ShaderVariantCache{ ShaderProgram::defaultVertexShaderSource(),
+                               ShaderProgram::defaultFragmentShaderSource() };
+}
+
+void ShaderVariantCache::request(std::span<ShaderDefine const> const defines) {
+    auto const [iterator, inserted] = mVariants.try_emplace(permutationKey(defines));
+    if (!inserted) {
+        return;
+    }
+    auto& variant = iterator->second;
+    variant.failed = !variant.program.beginCompile(
+            injectDefines(mVertexShaderSource, defines),
+            injectDefines(mFragmentShaderSource, defines)
+    );
+}
+
+ShaderProgram* ShaderVariantCache::get(std::span<ShaderDefine const> const defines) {
+    request(defines);
+    auto& variant = mVariants.at(permutationKey(defines));
+    finish(variant);
+    return variant.failed ? nullptr : &variant.program;
+}
+
+void ShaderVariantCache::poll() noexcept {
+    for (auto& [key, variant] : mVariants) {
+        if (variant.program.isCompilationPending() && variant.program.isCompilationComplete()) {
+            finish(variant);
+        }
+    }
+}
+
+void ShaderVariantCache::finishAll() noexcept {
+    for (auto& [key, variant] : mVariants) {
+        finish(variant);
+    }
+}
+
+std::size_t ShaderVariantCache::numPendingVariants() const noexcept {
+    return static_cast<std::size_t>(std::ranges::count_if(mVariants, [](auto const& entry) {
+        return entry.second.program.isCompilationPending();
+    }));
+}
+
+void ShaderVariantCache::finish(Variant& variant) noexcept {
+    if (!variant.failed && variant.program.isCompilationPending()) {
+        variant.failed = !variant.program.finishCompile();
+    }
+}
+
+std::uint64_t ShaderVariantCache::permutationKey(std::span<ShaderDefine const> const defines) {
+    // the order in which the defines are passed must not matter
+    auto sortedDefines = std::vector<ShaderDefine const*>{};
+    sortedDefines.reserve(defines.size());
+    for (auto const& define : defines) {
+        sortedDefines.push_back(&define);
+    }
+    std::ranges::sort(sortedDefines, [](auto const lhs, auto const rhs) { return lhs->name < rhs->name; });
+
+    auto result = std::uint64_t{ 0xcbf29ce484222325ULL };
+    auto const combine = [&result](std::string const& text) {
+        for (auto const c : text) {
+            result ^= static_cast<unsigned char>(c);
+            result *= 1099511628211ULL;
+        }
+        result *= 1099511628211ULL;
+    };
+    for (auto const define : sortedDefines) {
+        combine(define->name);
+        combine(define->value);
+    }
+    return result;
+}
+
+std::string ShaderVariantCache::injectDefines(std::string const& source, std::span<ShaderDefine const> const defines) {
+    // #version has to stay the first directive, so the defines go into the line after it
+    auto result = source;
+    auto insertPosition = std::size_t{ 0 };
+    if (auto const versionPosition = result.find("#version"); versionPosition != std::string::npos) {
+        auto const lineEnd = result.find('\n', versionPosition);
+        if (lineEnd == std::string::npos) {
+            result += '\n';
+            insertPosition = result.size();
+        } else {
+            insertPosition = lineEnd + 1;
+        }
+    }
+    auto const numPrecedingLines =
+            std::count(result.cbegin(), result.cbegin() + gsl::narrow_cast<std::ptrdiff_t>(insertPosition), '\n');
+
+    auto injected = std::string{};
+    for (auto const& define : defines) {
+        injected += fmt::format("#define {} {}\n", define.name, define.value);
+    }
+    // keep the line numbers of compiler errors in sync with the original source
+    injected += fmt::format("#line {}\n", numPrecedingLines + 1);
+    result.insert(insertPosition, injected);
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "shader_program.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ShaderDefine {
+    std::string name;
+    std::string value{ "1" };
+};
+
+// Specializes a pair of shader sources by injecting #define sets right after their #version directive. Every
+// permutation is compiled once and kept for the lifetime of the cache, so the returned program pointers stay
+// valid (and can be used in render commands).
+class ShaderVariantCache final {
+public:
+    ShaderVariantCache(std::string vertexShaderSource, std::string fragmentShaderSource);
+    ShaderVariantCache(ShaderVariantCache const&) = delete;
+    ShaderVariantCache(ShaderVariantCache&&) = default;
+    ShaderVariantCache& operator=(ShaderVariantCache const&) = delete;
+    ShaderVariantCache& operator=(ShaderVariantCache&&) = default;
+    ~ShaderVariantCache() = default;
+
+    // variants of ShaderProgram::defaultProgram()
+    [[nodiscard]] static ShaderVariantCache defaultVariants();
+
+    // Starts compiling the variant if it is not known yet. Requesting all variants up front and only then
+    // calling get() lets the driver compile them concurrently.
+    void request(std::span<ShaderDefine const> defines);
+    // returns nullptr if the variant failed to compile, blocks if it is still being compiled
+    [[nodiscard]] ShaderProgram* get(std::span<ShaderDefine const> defines);
+    // finishes all variants whose compilation has completed without blocking
+    void poll() noexcept;
+    void finishAll() noexcept;
+    [[nodiscard]] std::size_t numPendingVariants() const noexcept;
+
+    [[nodiscard]] static std::uint64_t permutationKey(std::span<ShaderDefine const> defines);
+    [[nodiscard]] static std::string injectDefines(std::string const& source, std::span<ShaderDefine const> defines);
+
+private:
+    struct Variant {
+        ShaderProgram program;
+        bool failed{ false };
+    };
+
+    static void finish(Variant& variant) noexcept;
+
+private:
+    std::string mVertexShaderSource;
+    std::string mFragmentShaderSource;
+    // node-based, so the programs don't move when new variants are added
+    std::unordered_map<std::uint64_t, Variant> mVariants;
+};
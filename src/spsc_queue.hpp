@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. The blocking operations sleep
+// via std::atomic::wait() instead of spinning.
+template<typename T, std::size_t Capacity>
+class SpscQueue final {
+    static_assert(std::has_single_bit(Capacity), "the capacity has to be a power of two");
+    static_assert(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_default_constructible_v<T>);
+
+public:
+    [[nodiscard]] bool tryPush(T value) noexcept {
+        auto const tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        publish(tail, std::move(value));
+        return true;
+    }
+
+    // blocks while the queue is full
+    void push(T value) noexcept {
+        auto const tail = mTail.load(std::memory_order_relaxed);
+        for (auto head = mHead.load(std::memory_order_acquire); tail - head == Capacity;
+             head = mHead.load(std::memory_order_acquire)) {
+            mHead.wait(head, std::memory_order_acquire);
+        }
+        publish(tail, std::move(value));
+    }
+
+    [[nodiscard]] std::optional<T> tryPop() noexcept {
+        auto const head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        return consume(head);
+    }
+
+    // blocks while the queue is empty
+    [[nodiscard]] T pop() noexcept {
+        auto const head = mHead.load(std::memory_order_relaxed);
+        for (auto tail = mTail.load(std::memory_order_acquire); head == tail;
+             tail = mTail.load(std::memory_order_acquire)) {
+            mTail.wait(tail, std::memory_order_acquire);
+        }
+        return consume(head);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    void publish(std::size_t const tail, T&& value) noexcept {
+        mSlots[tail & (Capacity - 1)] = std::move(value);
+        mTail.store(tail + 1, std::memory_order_release);
+        mTail.notify_one();
+    }
+
+    [[nodiscard]] T consume(std::size_t const head) noexcept {
+        auto result = std::move(mSlots[head & (Capacity - 1)]);
+        mHead.store(head + 1, std::memory_order_release);
+        mHead.notify_one();
+        return result;
+    }
+
+private:
+    // producer and consumer indices live on separate cache lines to avoid false sharing
+    static constexpr std::size_t cacheLineSize = 64;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> mHead{ 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> mTail{ 0 };
+    alignas(cacheLineSize) std::array<T, Capacity> mSlots{};
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "include_glm.hpp"
+#include "input.hpp"
+#include <cstdlib>
+#include <optional>
+
+// Calls plot for every pixel of the line from `from` to `to` (both included) in order (Bresenham).
+template<typename Plot>
+void rasterizeLine(glm::ivec2 const from, glm::ivec2 const to, Plot&& plot) {
+    auto const delta = glm::ivec2{ std::abs(to.x - from.x), -std::abs(to.y - from.y) };
+    auto const step = glm::ivec2{ from.x < to.x ? 1 : -1, from.y < to.y ? 1 : -1 };
+    auto error = delta.x + delta.y;
+    auto current = from;
+    while (true) {
+        plot(current);
+        if (current == to) {
+            return;
+        }
+        auto const doubledError = 2 * error;
+        if (doubledError >= delta.y) {
+            error += delta.y;
+            current.x += step.x;
+        }
+        if (doubledError <= delta.x) {
+            error += delta.x;
+            current.y += step.y;
+        }
+    }
+}
+
+// Turns the cursor movement while a mouse button is held into a continuous line of pixels. Every cursor event
+// since the last frame is used (not only the final position), and the line continues across frames.
+class Stroke final {
+public:
+    explicit Stroke(MouseButton const button) noexcept : mButton{ button } { }
+
+    // toPixel maps a cursor position (see Input::mousePosition()) to a glm::ivec2 pixel, plot is called once per
+    // pixel of the new part of the stroke
+    template<typename ToPixel, typename Plot>
+    void update(Input const& input, ToPixel&& toPixel, Plot&& plot) {
+        for (auto const& timestampedEvent : input.events()) {
+            auto const& event = timestampedEvent.event;
+            glm::ivec2 const pixel = toPixel(glm::vec2{ event.mouseX, event.mouseY });
+            switch (event.type) {
+                case InputEvent::Type::MouseMove:
+                    if (mLastPixel && pixel != *mLastPixel) {
+                        rasterizeLine(*mLastPixel, pixel, [&](glm::ivec2 const position) {
+                            if (position != *mLastPixel) {
+                                plot(position);
+                            }
+                        });
+                        mLastPixel = pixel;
+                    }
+                    break;
+                case InputEvent::Type::MouseButton:
+                    if (event.code != static_cast<int>(mButton)) {
+                        break;
+                    }
+                    if (event.action == GLFW_PRESS) {
+                        plot(pixel);
+                        mLastPixel = pixel;
+                    } else {
+                        mLastPixel.reset();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    [[nodiscard]] bool isActive() const noexcept {
+        return mLastPixel.has_value();
+    }
+
+private:
+    MouseButton mButton;
+    std::optional<glm::ivec2> mLastPixel;
+};
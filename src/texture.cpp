@@ -1,53 +1,40 @@
 #include "texture.hpp"
+#include "gl_state_cache.hpp"
+#include <algorithm>
+#include <cassert>
 #include <gsl/gsl>
 #include <range/v3/range.hpp>
 #include <range/v3/view/iota.hpp>
 
-tl::expected<Texture, std::string> Texture::create(Image const& image) noexcept {
-    GLint colorComponentFormat;
-    int const numChannels = image.getNumChannels();
-    switch (numChannels) {
-        case 3:
-            colorComponentFormat = GL_RGB;
-            break;
-        case 4:
-            colorComponentFormat = GL_RGBA;
-            break;
-        default:
-            return tl::unexpected{ fmt::format("Unsupported number of channels: {}", numChannels) };
+namespace {
+    [[nodiscard]] GLsizei mipmapLevelCount(int const width, int const height) noexcept {
+        GLsizei levels = 1;
+        for (auto size = std::max(width, height); size > 1; size /= 2) {
+            ++levels;
+        }
+        return levels;
     }
+} // namespace
 
-    Texture result;
-    glGenTextures(1, &result.mName);
-    result.bind();
-    glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            colorComponentFormat,
-            image.getWidth(),
-            image.getHeight(),
-            0,
-            colorComponentFormat,
-            GL_UNSIGNED_BYTE,
-            image.getData()
-    );
-    glGenerateMipmap(GL_TEXTURE_2D);
-    result.mWidth = image.getWidth();
-    result.mHeight = image.getHeight();
-    result.mNumChannels = image.getNumChannels();
-    result.setFiltering(Filtering::Linear);
-    result.setWrap(false);
+tl::expected<Texture, std::string> Texture::create(Image const& image) noexcept {
+    auto result = createFromMemory(image.getWidth(), image.getHeight(), image.getNumChannels(), image.getData());
+    if (result) {
+        result->setWrap(false);
+    }
     return result;
 }
 
 tl::expected<Texture, std::string>
 Texture::createFromMemory(int width, int height, int numChannels, unsigned char* data) noexcept {
-    GLint colorComponentFormat;
+    GLenum internalFormat;
+    GLenum colorComponentFormat;
     switch (numChannels) {
         case 3:
+            internalFormat = GL_RGB8;
             colorComponentFormat = GL_RGB;
             break;
         case 4:
+            internalFormat = GL_RGBA8;
             colorComponentFormat = GL_RGBA;
             break;
         default:
@@ -55,23 +42,14 @@ Texture::createFromMemory(int width, int height, int numChannels, unsigned char*
     }
 
     Texture result;
-    glGenTextures(1, &result.mName);
-    result.bind();
-    glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            colorComponentFormat,
-            width,
-            height,
-            0,
-            colorComponentFormat,
-            GL_UNSIGNED_BYTE,
-            data
-    );
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glCreateTextures(GL_TEXTURE_2D, 1, &result.mName);
+    glTextureStorage2D(result.mName, mipmapLevelCount(width, height), internalFormat, width, height);
+    glTextureSubImage2D(result.mName, 0, 0, 0, width, height, colorComponentFormat, GL_UNSIGNED_BYTE, data);
+    glGenerateTextureMipmap(result.mName);
     result.mWidth = width;
     result.mHeight = height;
     result.mNumChannels = numChannels;
+    result.mInternalFormat = internalFormat;
     result.setFiltering(Filtering::Linear);
     result.setWrap(true);
     return result;
@@ -93,14 +71,83 @@ Texture::createFromFillColor(int width, int height, int numChannels, Color fillC
     return createFromMemory(width, height, numChannels, buffer.get());
 }
 
+tl::expected<Texture, std::string>
+Texture::createForStorage(int const width, int const height, GLenum const internalFormat) noexcept {
+    if (width <= 0 || height <= 0) {
+        return tl::unexpected{ fmt::format("Invalid texture size: {}x{}", width, height) };
+    }
+    // image load/store only works with sized formats, RGBA8 matches the CPU side pixel layout
+    if (internalFormat != GL_RGBA8 && internalFormat != GL_SRGB8_ALPHA8 && internalFormat != GL_RGBA16F) {
+        return tl::unexpected{ fmt::format("Unsupported storage texture format: 0x{:X}", internalFormat) };
+    }
+    Texture result;
+    glCreateTextures(GL_TEXTURE_2D, 1, &result.mName);
+    glTextureStorage2D(result.mName, 1, internalFormat, width, height);
+    result.mWidth = width;
+    result.mHeight = height;
+    result.mNumChannels = 4;
+    result.mInternalFormat = internalFormat;
+    glTextureParameteri(result.mName, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(result.mName, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    result.setWrap(false);
+    return result;
+}
+
+void Texture::setData(std::span<unsigned char const> const data) const noexcept {
+    assert(data.size() == static_cast<std::size_t>(mWidth * mHeight * mNumChannels));
+    glTextureSubImage2D(
+            mName,
+            0,
+            0,
+            0,
+            mWidth,
+            mHeight,
+            mNumChannels == 4 ? GL_RGBA : GL_RGB,
+            GL_UNSIGNED_BYTE,
+            data.data()
+    );
+}
+
+void Texture::readData(std::span<unsigned char> const data) const noexcept {
+    assert(data.size() == static_cast<std::size_t>(mWidth * mHeight * mNumChannels));
+    glGetTextureImage(
+            mName,
+            0,
+            mNumChannels == 4 ? GL_RGBA : GL_RGB,
+            GL_UNSIGNED_BYTE,
+            gsl::narrow_cast<GLsizei>(data.size()),
+            data.data()
+    );
+}
+
+void Texture::fillRegion(
+        int const x,
+        int const y,
+        int const width,
+        int const height,
+        std::span<unsigned char const> const pixel
+) const noexcept {
+    assert(pixel.size() == static_cast<std::size_t>(mNumChannels));
+    glClearTexSubImage(
+            mName,
+            0,
+            x,
+            y,
+            0,
+            width,
+            height,
+            1,
+            mNumChannels == 4 ? GL_RGBA : GL_RGB,
+            GL_UNSIGNED_BYTE,
+            pixel.data()
+    );
+}
+
+void Texture::bindImage(GLuint const imageUnit, GLenum const access) const noexcept {
+    glBindImageTexture(imageUnit, mName, 0, GL_FALSE, 0, access, mInternalFormat);
+}
 
 void Texture::bind(GLint textureUnit) const noexcept {
-    /*if (textureUnit < 0 || textureUnit >= getTextureUnitCount()) {
-        spdlog::error("Cannot bind texture since {} is no valid texture unit.", textureUnit);
-        return;
-    }
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, mName);*/
     bind(mName, textureUnit);
 }
 
@@ -109,8 +156,7 @@ void Texture::unbind(GLint textureUnit) noexcept {
         spdlog::error("Cannot unbind texture since {} is no valid texture unit.", textureUnit);
         return;
     }
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::instance().bindTextureUnit(static_cast<GLuint>(textureUnit), 0U);
 }
 
 GLint Texture::getTextureUnitCount() noexcept {
@@ -122,17 +168,13 @@ GLint Texture::getTextureUnitCount() noexcept {
 }
 
 void Texture::setFiltering(Texture::Filtering filtering) const noexcept {
-    // TODO: Remove unnecessary binds
-    bind();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering == Filtering::Linear ? GL_LINEAR : GL_NEAREST);
+    glTextureParameteri(mName, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(mName, GL_TEXTURE_MAG_FILTER, filtering == Filtering::Linear ? GL_LINEAR : GL_NEAREST);
 }
 
 void Texture::setWrap(bool enabled) const noexcept {
-    // TODO: Remove unnecessary binds
-    bind();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, enabled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, enabled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    glTextureParameteri(mName, GL_TEXTURE_WRAP_S, enabled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    glTextureParameteri(mName, GL_TEXTURE_WRAP_T, enabled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
 }
 
 Texture::Texture(Texture&& other) noexcept {
@@ -141,10 +183,12 @@ Texture::Texture(Texture&& other) noexcept {
     swap(mWidth, other.mWidth);
     swap(mHeight, other.mHeight);
     swap(mNumChannels, other.mNumChannels);
+    swap(mInternalFormat, other.mInternalFormat);
     swap(guid, other.guid);
 }
 
 Texture::~Texture() {
+    GLStateCache::instance().onTextureDeleted(mName);
     glDeleteTextures(1, &mName);
 }
 
@@ -154,6 +198,7 @@ Texture& Texture::operator=(Texture&& other) noexcept {
     swap(mWidth, other.mWidth);
     swap(mHeight, other.mHeight);
     swap(mNumChannels, other.mNumChannels);
+    swap(mInternalFormat, other.mInternalFormat);
     swap(guid, other.guid);
     return *this;
 }
@@ -163,6 +208,5 @@ void Texture::bind(GLuint textureName, GLint textureUnit) noexcept {
         spdlog::error("Cannot bind texture since {} is no valid texture unit.", textureUnit);
         return;
     }
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, textureName);
+    GLStateCache::instance().bindTextureUnit(static_cast<GLuint>(textureUnit), textureName);
 }
@@ -8,6 +8,7 @@
 #include "guid.hpp"
 #include "image.hpp"
 #include <glad/gl.h>
+#include <span>
 #include <tl/expected.hpp>
 
 
@@ -32,6 +33,13 @@ public:
     static void unbind(GLint textureUnit) noexcept;
     void setFiltering(Filtering filtering) const noexcept;
     void setWrap(bool enabled) const noexcept;
+    // replaces the contents of the base level (tightly packed, numChannels bytes per pixel)
+    void setData(std::span<unsigned char const> data) const noexcept;
+    void readData(std::span<unsigned char> data) const noexcept;
+    // sets every pixel of the region of the base level to the given value (numChannels bytes)
+    void fillRegion(int x, int y, int width, int height, std::span<unsigned char const> pixel) const noexcept;
+    // binds the base level to an image unit for load/store access in shaders
+    void bindImage(GLuint imageUnit, GLenum access) const noexcept;
     [[nodiscard]] int width() const noexcept {
         return mWidth;
     }
@@ -50,6 +58,9 @@ public:
     createFromMemory(int width, int height, int numChannels, unsigned char* data) noexcept;
     [[nodiscard]] static tl::expected<Texture, std::string>
     createFromFillColor(int width, int height, int numChannels, Color fillColor) noexcept;
+    // texture without mipmaps that can be written by compute shaders (as image) or via setData()
+    [[nodiscard]] static tl::expected<Texture, std::string>
+    createForStorage(int width, int height, GLenum internalFormat = GL_RGBA8) noexcept;
     [[nodiscard]] static GLint getTextureUnitCount() noexcept;
 
 public:
@@ -63,7 +74,9 @@ private:
     int mWidth{ 0U };
     int mHeight{ 0U };
     int mNumChannels{ 0U };
+    GLenum mInternalFormat{ GL_NONE };
     GLuint mName{ 0U };
 
     friend class Renderer;
+    friend class RenderTarget;
 };
@@ -4,8 +4,13 @@ struct Time {
     double elapsed{ 1.0 / 60.0 };
     double delta{ 1.0 / 60.0 };
     double meanFramesPerSecond{ 1.0 / 60.0 };
+    // the simulation advances in fixed steps of fixedDelta seconds (see Application::fixedUpdate())
+    double fixedDelta{ 1.0 / 120.0 };
+    double simulationElapsed{ 0.0 };
+    // blend factor between the previous and the current simulation state for rendering
+    double interpolationAlpha{ 0.0 };
 
     [[nodiscard]] double meanFrameTime() const noexcept {
         return 1.0 / meanFramesPerSecond;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,256 @@
+#include "trace_capture.hpp"
+#include "allocation_tracker.hpp"
+#include "scoped_timer.hpp"
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <tuple>
+
+namespace {
+    [[nodiscard]] std::string escapeJson(std::string_view const text) {
+        auto result = std::string{};
+        result.reserve(text.size());
+        for (auto const character : text) {
+            switch (character) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                default:
+                    result += character;
+                    break;
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::string zoneName(ScopedTimer::Zone const& zone) {
+        return escapeJson(*zone.name == '\0' ? zone.sourceLocation.function_name() : zone.name);
+    }
+
+    // trace timestamps are in microseconds
+    [[nodiscard]] double toMicroseconds(std::int64_t const nanoseconds) noexcept {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+
+    constexpr auto processId = 1;
+} // namespace
+
+std::filesystem::path TraceCapture::defaultOutputFile() {
+    auto const time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    auto timeBuffer = std::tm{};
+#ifdef _WIN32
+    localtime_s(&timeBuffer, &time);
+#else
+    localtime_r(&time, &timeBuffer);
+#endif
+    auto name = std::array<char, 64>{};
+    std::strftime(name.data(), name.size(), "pixelator_trace_%Y%m%d_%H%M%S.json", &timeBuffer);
+    return name.data();
+}
+
+void TraceCapture::start(std::filesystem::path outputFile) {
+    {
+        auto const lock = std::scoped_lock{ sMutex };
+        if (sIsCapturing) {
+            return;
+        }
+        sIsCapturing = true;
+        sOutputFile = std::move(outputFile);
+        sStartTime = ScopedTimer::now();
+        sMarkers.clear();
+        sNumDroppedMarkers = 0;
+    }
+    // discard the events that were recorded before
+    std::ignore = ScopedTimer::takeTraceEvents();
+    ScopedTimer::setTracingEnabled(true);
+#if !ENABLE_PROFILING
+    spdlog::warn("trace capture started, but only frame markers and counters are recorded without ENABLE_PROFILING");
+#else
+    spdlog::info("trace capture started");
+#endif
+}
+
+tl::expected<void, std::string> TraceCapture::stop() {
+    ScopedTimer::setTracingEnabled(false);
+    auto const threadTraces = ScopedTimer::takeTraceEvents();
+    auto const lock = std::scoped_lock{ sMutex };
+    if (!sIsCapturing) {
+        return tl::unexpected{ std::string{ "no trace capture is running" } };
+    }
+    sIsCapturing = false;
+
+    auto file = std::ofstream{ sOutputFile };
+    if (!file) {
+        return tl::unexpected{ fmt::format("unable to open trace file '{}'", sOutputFile.string()) };
+    }
+    auto buffer = fmt::memory_buffer{};
+    auto output = std::back_inserter(buffer);
+    fmt::format_to(output, R"({{"displayTimeUnit":"ms","traceEvents":[)");
+    fmt::format_to(
+            output,
+            R"({{"name":"process_name","ph":"M","pid":{},"tid":0,"args":{{"name":"pixelator"}}}})",
+            processId
+    );
+
+    std::size_t numEvents = 0;
+    std::uint64_t numDroppedEvents = 0;
+    for (auto const& thread : threadTraces) {
+        numDroppedEvents += thread.numDroppedEvents;
+        fmt::format_to(
+                output,
+                R"(,{{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":"{}"}}}})",
+                processId,
+                thread.threadId,
+                escapeJson(thread.threadName)
+        );
+        for (auto const& event : thread.events) {
+            if (event.beginTime < sStartTime) {
+                continue;
+            }
+            fmt::format_to(
+                    output,
+                    R"(,{{"name":"{}","cat":"cpu","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{})",
+                    zoneName(ScopedTimer::zone(event.zone)),
+                    toMicroseconds(event.beginTime - sStartTime),
+                    toMicroseconds(event.endTime - event.beginTime),
+                    processId,
+                    thread.threadId
+            );
+            if constexpr (AllocationTracker::isEnabled()) {
+                fmt::format_to(
+                        output,
+                        R"(,"args":{{"allocations":{},"allocated_bytes":{}}})",
+                        event.numAllocations,
+                        event.numAllocatedBytes
+                );
+            }
+            fmt::format_to(output, "}}");
+            ++numEvents;
+        }
+    }
+    for (auto const& marker : sMarkers) {
+        auto const timestamp = toMicroseconds(marker.time - sStartTime);
+        if (marker.type == Marker::Type::Frame) {
+            fmt::format_to(
+                    output,
+                    R"(,{{"name":"frame {}","cat":"frame","ph":"i","s":"g","ts":{:.3f},"pid":{},"tid":0}})",
+                    static_cast<std::uint64_t>(marker.value),
+                    timestamp,
+                    processId
+            );
+        } else {
+            fmt::format_to(
+                    output,
+                    R"(,{{"name":"{}","ph":"C","ts":{:.3f},"pid":{},"args":{{"value":{}}}}})",
+                    marker.name,
+                    timestamp,
+                    processId,
+                    marker.value
+            );
+        }
+    }
+    fmt::format_to(output, "]}}\n");
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        return tl::unexpected{ fmt::format("unable to write trace file '{}'", sOutputFile.string()) };
+    }
+    spdlog::info(
+            "trace with {} events, {} markers and counters written to '{}'",
+            numEvents,
+            sMarkers.size(),
+            sOutputFile.string()
+    );
+    if (numDroppedEvents > 0 || sNumDroppedMarkers > 0) {
+        spdlog::warn(
+                "the trace is incomplete, {} events and {} markers and counters were dropped",
+                numDroppedEvents,
+                sNumDroppedMarkers
+        );
+    }
+    sMarkers.clear();
+    return {};
+}
+
+void TraceCapture::toggle() {
+    if (!isCapturing()) {
+        start();
+        return;
+    }
+    if (auto const result = stop(); !result) {
+        spdlog::error("trace capture failed: {}", result.error());
+    }
+}
+
+bool TraceCapture::isCapturing() noexcept {
+    return sIsCapturing.load(std::memory_order_relaxed);
+}
+
+void TraceCapture::captureFrameRange(TraceFrameRange const range, std::filesystem::path outputFile) {
+    auto const lock = std::scoped_lock{ sMutex };
+    sPendingFrameRange = range;
+    sFrameRangeOutputFile = std::move(outputFile);
+    sHasPendingFrameRange = true;
+}
+
+void TraceCapture::nextFrame(std::uint64_t const frameNumber) {
+    if (!sIsCapturing.load(std::memory_order_relaxed) && !sHasPendingFrameRange.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto startOutputFile = std::optional<std::filesystem::path>{};
+    auto shouldStop = false;
+    {
+        auto const lock = std::scoped_lock{ sMutex };
+        if (sPendingFrameRange) {
+            if (frameNumber == sPendingFrameRange->firstFrame + sPendingFrameRange->numFrames) {
+                sPendingFrameRange.reset();
+                sHasPendingFrameRange = false;
+                shouldStop = sIsCapturing;
+            } else if (frameNumber == sPendingFrameRange->firstFrame && !sIsCapturing) {
+                startOutputFile = sFrameRangeOutputFile;
+            }
+        }
+        if (sIsCapturing && !shouldStop) {
+            pushMarker(Marker{ .type{ Marker::Type::Frame },
+                                       .name{ "frame" },
+                                       .time{ ScopedTimer::now() },
+                                       .value{ static_cast<double>(frameNumber) } });
+        }
+    }
+    if (shouldStop) {
+        if (auto const result = stop(); !result) {
+            spdlog::error("trace capture failed: {}", result.error());
+        }
+    } else if (startOutputFile) {
+        start(std::move(*startOutputFile));
+        nextFrame(frameNumber);
+    }
+}
+
+void TraceCapture::counter(char const* const name, double const value) {
+    if (!sIsCapturing.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto const lock = std::scoped_lock{ sMutex };
+    if (!sIsCapturing) {
+        return;
+    }
+    pushMarker(Marker{ .type{ Marker::Type::Counter }, .name{ name }, .time{ ScopedTimer::now() }, .value{ value } });
+}
+
+void TraceCapture::pushMarker(Marker const& marker) {
+    if (sMarkers.size() < maxMarkers) {
+        sMarkers.push_back(marker);
+    } else {
+        ++sNumDroppedMarkers;
+    }
+}
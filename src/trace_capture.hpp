@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tl/expected.hpp>
+#include <vector>
+
+struct TraceFrameRange {
+    std::uint64_t firstFrame;
+    std::uint64_t numFrames;
+};
+
+// Records the events of all ScopedTimers (requires ENABLE_PROFILING), frame markers and counters and writes them
+// as Chrome trace JSON (chrome://tracing, https://ui.perfetto.dev).
+class TraceCapture final {
+public:
+    [[nodiscard]] static std::filesystem::path defaultOutputFile();
+    static void start(std::filesystem::path outputFile = defaultOutputFile());
+    // writes the trace file
+    static tl::expected<void, std::string> stop();
+    static void toggle();
+    [[nodiscard]] static bool isCapturing() noexcept;
+    // starts a capture when the given frame begins and stops it after numFrames frames
+    static void captureFrameRange(TraceFrameRange range, std::filesystem::path outputFile = defaultOutputFile());
+
+    // has to be called once per frame, frameNumber is the number of the frame that starts now
+    static void nextFrame(std::uint64_t frameNumber);
+    // ignored while not capturing, name has to be a string literal
+    static void counter(char const* name, double value);
+
+    // frame markers and counters beyond this limit are dropped
+    static constexpr std::size_t maxMarkers = std::size_t{ 1 } << 20;
+
+private:
+    struct Marker {
+        enum class Type {
+            Frame,
+            Counter,
+        };
+
+        Type type;
+        char const* name;
+        std::int64_t time;
+        double value;
+    };
+
+private:
+    // sMutex has to be held
+    static void pushMarker(Marker const& marker);
+
+private:
+    static inline std::mutex sMutex{};
+    // only written while holding sMutex, read without the lock to keep nextFrame() and counter() cheap
+    static inline std::atomic_bool sIsCapturing{ false };
+    static inline std::atomic_bool sHasPendingFrameRange{ false };
+    static inline std::int64_t sStartTime{ 0 };
+    static inline std::filesystem::path sOutputFile{};
+    static inline std::vector<Marker> sMarkers{};
+    static inline std::size_t sNumDroppedMarkers{ 0 };
+    static inline std::optional<TraceFrameRange> sPendingFrameRange{};
+    static inline std::filesystem::path sFrameRangeOutputFile{};
+};
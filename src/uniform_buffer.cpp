@@ -0,0 +1,42 @@
+#include "uniform_buffer.hpp"
+#include "gl_state_cache.hpp"
+#include <cassert>
+#include <gsl/gsl>
+#include <utility>
+
+UniformBuffer::UniformBuffer(std::size_t const size) noexcept : mSize{ size } {
+    glCreateBuffers(1U, &mName);
+    glNamedBufferStorage(mName, gsl::narrow_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept {
+    using std::swap;
+    swap(mName, other.mName);
+    swap(mSize, other.mSize);
+}
+
+UniformBuffer::~UniformBuffer() {
+    GLStateCache::instance().onBufferDeleted(mName);
+    glDeleteBuffers(1U, &mName);
+}
+
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+    using std::swap;
+    swap(mName, other.mName);
+    swap(mSize, other.mSize);
+    return *this;
+}
+
+void UniformBuffer::setData(std::span<std::byte const> const data, std::size_t const offset) const noexcept {
+    assert(offset + data.size() <= mSize);
+    glNamedBufferSubData(
+            mName,
+            gsl::narrow_cast<GLintptr>(offset),
+            gsl::narrow_cast<GLsizeiptr>(data.size()),
+            data.data()
+    );
+}
+
+void UniformBuffer::bind(GLuint const bindingPoint) const noexcept {
+    GLStateCache::instance().bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, mName);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <glad/gl.h>
+#include <span>
+#include <type_traits>
+
+// Fixed-size uniform buffer object. The memory layout of the uploaded data has to match the std140
+// layout of the uniform block in the shader(s), so prefer vec4/mat4 members and explicit padding.
+class UniformBuffer final {
+public:
+    UniformBuffer() = default;
+    explicit UniformBuffer(std::size_t size) noexcept;
+    UniformBuffer(UniformBuffer const&) = delete;
+    UniformBuffer(UniformBuffer&& other) noexcept;
+    ~UniformBuffer();
+
+    UniformBuffer& operator=(UniformBuffer const&) = delete;
+    UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+    void setData(std::span<std::byte const> data, std::size_t offset = 0) const noexcept;
+    template<typename T>
+    void setData(T const& data, std::size_t const offset = 0) const noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+        setData(std::as_bytes(std::span{ &data, 1 }), offset);
+    }
+    void bind(GLuint bindingPoint) const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept {
+        return mSize;
+    }
+
+private:
+    GLuint mName{ 0U };
+    std::size_t mSize{ 0U };
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "include_glm.hpp"
+#include <algorithm>
+#include <glad/gl.h>
+
+// value type for sampler uniforms, holds the texture unit the sampler reads from
+struct Sampler {
+    GLint textureUnit;
+};
+
+// Location of a uniform of the default uniform block, resolved once by ShaderProgram::uniformHandle().
+// Handles stay valid for the lifetime of the program they were resolved from (recompiling invalidates them).
+template<typename T>
+class UniformHandle final {
+public:
+    UniformHandle() = default;
+
+    [[nodiscard]] bool isValid() const noexcept {
+        return mLocation >= 0;
+    }
+    [[nodiscard]] GLint location() const noexcept {
+        return mLocation;
+    }
+
+private:
+    explicit UniformHandle(GLint const location) noexcept : mLocation{ location } { }
+
+private:
+    GLint mLocation{ -1 };
+
+    friend class ShaderProgram;
+};
+
+namespace detail {
+    template<typename T>
+    struct UniformTraits;
+
+#define C2K_UNIFORM_TRAITS(Type, GLType, function)                                                  \
+    template<>                                                                                      \
+    struct UniformTraits<Type> {                                                                    \
+        [[nodiscard]] static bool matches(GLenum const type) noexcept {                             \
+            return type == (GLType);                                                                \
+        }                                                                                           \
+        static void set(GLuint program, GLint location, GLsizei count, Type const* values) noexcept { \
+            function(program, location, count, values);                                             \
+        }                                                                                           \
+    };
+
+#define C2K_UNIFORM_TRAITS_GLM(Type, GLType, function)                                              \
+    template<>                                                                                      \
+    struct UniformTraits<Type> {                                                                    \
+        [[nodiscard]] static bool matches(GLenum const type) noexcept {                             \
+            return type == (GLType);                                                                \
+        }                                                                                           \
+        static void set(GLuint program, GLint location, GLsizei count, Type const* values) noexcept { \
+            function(program, location, count, glm::value_ptr(*values));                            \
+        }                                                                                           \
+    };
+
+#define C2K_UNIFORM_TRAITS_MATRIX(Type, GLType, function)                                           \
+    template<>                                                                                      \
+    struct UniformTraits<Type> {                                                                    \
+        [[nodiscard]] static bool matches(GLenum const type) noexcept {                             \
+            return type == (GLType);                                                                \
+        }                                                                                           \
+        static void set(GLuint program, GLint location, GLsizei count, Type const* values) noexcept { \
+            function(program, location, count, GL_FALSE, glm::value_ptr(*values));                  \
+        }                                                                                           \
+    };
+
+    C2K_UNIFORM_TRAITS(GLfloat, GL_FLOAT, glProgramUniform1fv)
+    C2K_UNIFORM_TRAITS(GLint, GL_INT, glProgramUniform1iv)
+    C2K_UNIFORM_TRAITS(GLuint, GL_UNSIGNED_INT, glProgramUniform1uiv)
+    C2K_UNIFORM_TRAITS_GLM(glm::vec2, GL_FLOAT_VEC2, glProgramUniform2fv)
+    C2K_UNIFORM_TRAITS_GLM(glm::vec3, GL_FLOAT_VEC3, glProgramUniform3fv)
+    C2K_UNIFORM_TRAITS_GLM(glm::vec4, GL_FLOAT_VEC4, glProgramUniform4fv)
+    C2K_UNIFORM_TRAITS_GLM(glm::ivec2, GL_INT_VEC2, glProgramUniform2iv)
+    C2K_UNIFORM_TRAITS_GLM(glm::ivec3, GL_INT_VEC3, glProgramUniform3iv)
+    C2K_UNIFORM_TRAITS_GLM(glm::ivec4, GL_INT_VEC4, glProgramUniform4iv)
+    C2K_UNIFORM_TRAITS_GLM(glm::uvec2, GL_UNSIGNED_INT_VEC2, glProgramUniform2uiv)
+    C2K_UNIFORM_TRAITS_GLM(glm::uvec3, GL_UNSIGNED_INT_VEC3, glProgramUniform3uiv)
+    C2K_UNIFORM_TRAITS_GLM(glm::uvec4, GL_UNSIGNED_INT_VEC4, glProgramUniform4uiv)
+    C2K_UNIFORM_TRAITS_MATRIX(glm::mat2, GL_FLOAT_MAT2, glProgramUniformMatrix2fv)
+    C2K_UNIFORM_TRAITS_MATRIX(glm::mat3, GL_FLOAT_MAT3, glProgramUniformMatrix3fv)
+    C2K_UNIFORM_TRAITS_MATRIX(glm::mat4, GL_FLOAT_MAT4, glProgramUniformMatrix4fv)
+
+#undef C2K_UNIFORM_TRAITS
+#undef C2K_UNIFORM_TRAITS_GLM
+#undef C2K_UNIFORM_TRAITS_MATRIX
+
+    // booleans and samplers are set through the integer functions, but they don't share the memory layout
+    // of GLint, so every element is set on its own (array elements have consecutive locations)
+    template<>
+    struct UniformTraits<bool> {
+        [[nodiscard]] static bool matches(GLenum const type) noexcept {
+            return type == GL_BOOL;
+        }
+        static void set(GLuint const program, GLint const location, GLsizei const count, bool const* values) noexcept {
+            for (GLsizei i = 0; i < count; ++i) {
+                glProgramUniform1i(program, location + i, values[i] ? 1 : 0);
+            }
+        }
+    };
+
+    template<>
+    struct UniformTraits<Sampler> {
+        [[nodiscard]] static bool matches(GLenum const type) noexcept {
+            constexpr GLenum samplerTypes[] = {
+                GL_SAMPLER_1D,
+                GL_SAMPLER_2D,
+                GL_SAMPLER_3D,
+                GL_SAMPLER_CUBE,
+                GL_SAMPLER_1D_ARRAY,
+                GL_SAMPLER_2D_ARRAY,
+                GL_SAMPLER_2D_SHADOW,
+                GL_SAMPLER_BUFFER,
+                GL_SAMPLER_2D_MULTISAMPLE,
+                GL_INT_SAMPLER_2D,
+                GL_INT_SAMPLER_2D_ARRAY,
+                GL_UNSIGNED_INT_SAMPLER_2D,
+                GL_UNSIGNED_INT_SAMPLER_2D_ARRAY,
+            };
+            return std::ranges::find(samplerTypes, type) != std::ranges::end(samplerTypes);
+        }
+        static void
+        set(GLuint const program, GLint const location, GLsizei const count, Sampler const* values) noexcept {
+            for (GLsizei i = 0; i < count; ++i) {
+                glProgramUniform1i(program, location + i, values[i].textureUnit);
+            }
+        }
+    };
+} // namespace detail
@@ -3,12 +3,19 @@
 #include <glad/gl.h>
 
 struct VertexAttributeDefinition {
-    VertexAttributeDefinition(GLint const count, GLenum const type, GLboolean const normalized) noexcept
+    VertexAttributeDefinition(
+            GLint const count,
+            GLenum const type,
+            GLboolean const normalized,
+            GLsizei const padding = 0
+    ) noexcept
         : count{ count },
           type{ type },
-          normalized{ normalized } { }
+          normalized{ normalized },
+          padding{ padding } { }
 
     GLint count; // e.g. 3 for a vec3 position vector
     GLenum type; // e.g. GL_FLOAT
     GLboolean normalized;
+    GLsizei padding; // unused bytes after the attribute, e.g. to keep the next attribute 4-byte aligned
 };
@@ -1,4 +1,5 @@
 #include "vertex_buffer.hpp"
+#include "gl_state_cache.hpp"
 
 VertexBuffer::VertexBuffer(
         GLDataUsagePattern usagePattern,
@@ -38,6 +39,10 @@ VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept {
 }
 
 VertexBuffer::~VertexBuffer() {
+    auto& stateCache = GLStateCache::instance();
+    stateCache.onBufferDeleted(mVertexBufferObjectName);
+    stateCache.onBufferDeleted(mElementBufferObjectName);
+    stateCache.onVertexArrayDeleted(mVertexArrayObjectName);
     glDeleteBuffers(1U, &mVertexBufferObjectName);
     glDeleteVertexArrays(1U, &mVertexArrayObjectName);
     glDeleteBuffers(1U, &mElementBufferObjectName);
@@ -52,56 +57,12 @@ VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept {
     return *this;
 }
 
+// the vertex buffer and the element buffer are attached to the vertex array object, so binding
+// the vertex array object is sufficient for drawing
 void VertexBuffer::bind() const noexcept {
-    bindVertexArrayObject();
-    bindVertexBufferObject();
-    bindElementBufferObject();
+    GLStateCache::instance().bindVertexArray(mVertexArrayObjectName);
 }
 
 void VertexBuffer::unbind() noexcept {
-    unbindElementBufferObject();
-    unbindVertexBufferObject();
-    unbindVertexArrayObject();
-}
-
-void VertexBuffer::bindVertexArrayObject() const noexcept {
-    if (sCurrentlyBoundVertexArrayObjectName != mVertexArrayObjectName) {
-        glBindVertexArray(mVertexArrayObjectName);
-        sCurrentlyBoundVertexArrayObjectName = mVertexArrayObjectName;
-    }
-}
-
-void VertexBuffer::bindVertexBufferObject() const noexcept {
-    if (sCurrentlyBoundVertexBufferObjectName != mVertexBufferObjectName) {
-        glBindBuffer(GL_ARRAY_BUFFER, mVertexBufferObjectName);
-        sCurrentlyBoundVertexBufferObjectName = mVertexBufferObjectName;
-    }
-}
-
-void VertexBuffer::bindElementBufferObject() const noexcept {
-    if (sCurrentlyBoundElementBufferObjectName != mElementBufferObjectName) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mElementBufferObjectName);
-        sCurrentlyBoundElementBufferObjectName = mElementBufferObjectName;
-    }
-}
-
-void VertexBuffer::unbindVertexArrayObject() noexcept {
-    if (sCurrentlyBoundVertexArrayObjectName != 0U) {
-        glBindBuffer(GL_ARRAY_BUFFER, 0U);
-        sCurrentlyBoundVertexArrayObjectName = 0U;
-    }
-}
-
-void VertexBuffer::unbindVertexBufferObject() noexcept {
-    if (sCurrentlyBoundVertexBufferObjectName != 0U) {
-        glBindVertexArray(0U);
-        sCurrentlyBoundVertexBufferObjectName = 0U;
-    }
-}
-
-void VertexBuffer::unbindElementBufferObject() noexcept {
-    if (sCurrentlyBoundElementBufferObjectName != 0U) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0U);
-        sCurrentlyBoundElementBufferObjectName = 0U;
-    }
+    GLStateCache::instance().bindVertexArray(0U);
 }
@@ -81,17 +81,6 @@ public:
     }
 
 private:
-    void bindVertexArrayObject() const noexcept;
-    void bindVertexBufferObject() const noexcept;
-    void bindElementBufferObject() const noexcept;
-    static void unbindVertexArrayObject() noexcept;
-    static void unbindVertexBufferObject() noexcept;
-    static void unbindElementBufferObject() noexcept;
-
-private:
-    static inline GLuint sCurrentlyBoundVertexArrayObjectName{ 0U };
-    static inline GLuint sCurrentlyBoundVertexBufferObjectName{ 0U };
-    static inline GLuint sCurrentlyBoundElementBufferObjectName{ 0U };
     GLuint mVertexArrayObjectName{ 0U };
     GLuint mVertexBufferObjectName{ 0U };
     GLuint mElementBufferObjectName{ 0U };
@@ -108,7 +97,8 @@ void VertexBuffer::setVertexAttributeLayout(std::convertible_to<VertexAttributeD
     GLsizei stride{ 0 };
     // calculate stride
     std::for_each(values.begin(), values.end(), [&stride](VertexAttributeDefinition const& definition) {
-        stride += gsl::narrow_cast<GLsizei>(get_size_of_gl_type(definition.type) * definition.count);
+        stride += gsl::narrow_cast<GLsizei>(get_size_of_gl_type(definition.type) * definition.count)
+                  + definition.padding;
     });
 
     // set vertex attributes
@@ -118,7 +108,8 @@ void VertexBuffer::setVertexAttributeLayout(std::convertible_to<VertexAttributeD
             [this, &location, &offset, stride](VertexAttributeDefinition const& definition) {
                 glEnableVertexArrayAttrib(mVertexArrayObjectName, location);
                 glVertexArrayVertexBuffer(mVertexArrayObjectName, 0, mVertexBufferObjectName, 0, stride);
-                if (is_integral_type(definition.type)) {
+                // normalized integers (packed colors and texture coordinates) are read as floats by the shader
+                if (is_integral_type(definition.type) && definition.normalized == GL_FALSE) {
                     glVertexArrayAttribIFormat(
                             mVertexArrayObjectName,
                             location,
@@ -139,16 +130,18 @@ void VertexBuffer::setVertexAttributeLayout(std::convertible_to<VertexAttributeD
                 glVertexArrayAttribBinding(mVertexArrayObjectName, location, 0);
                 spdlog::info(
                         "Enabled vertex attribute {} (count {}, type {}, normalized {}, stride {}, "
-                        "offset {})",
+                        "offset {}, padding {})",
                         location,
                         definition.count,
                         definition.type,
                         definition.normalized,
                         stride,
-                        offset
+                        offset,
+                        definition.padding
                 );
                 ++location;
-                offset += get_size_of_gl_type(definition.type) * definition.count;
+                offset += get_size_of_gl_type(definition.type) * definition.count
+                          + gsl::narrow_cast<std::uintptr_t>(definition.padding);
             }
     );
     // attach index buffer to vertex array object
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "color.hpp"
+#include "include_glm.hpp"
+#include "rect.hpp"
+#include "vertex_attribute_definition.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+
+enum class VertexFormat {
+    // float position, float color, float texture coordinates, 32 bit texture index (40 bytes)
+    Standard,
+    // float position, RGBA8 color, 16 bit normalized texture coordinates, 8 bit texture index (24 bytes)
+    Compact,
+    // same as Compact, but with half float positions (20 bytes)
+    CompactHalfPosition,
+};
+
+namespace detail {
+    [[nodiscard]] inline glm::u8vec4 packColor(Color const& color) noexcept {
+        return glm::u8vec4{ glm::round(glm::clamp(glm::vec4{ color }, 0.0f, 1.0f) * 255.0f) };
+    }
+
+    // Normalized 16 bit texture coordinates can only represent the range [0, 1], so texture
+    // rects that rely on wrapping have to use the standard vertex format.
+    [[nodiscard]] inline glm::u16vec2 packTexCoords(glm::vec2 const& texCoords) noexcept {
+        return glm::u16vec2{ glm::round(glm::clamp(texCoords, 0.0f, 1.0f) * 65535.0f) };
+    }
+} // namespace detail
+
+struct StandardVertex {
+    glm::vec3 position;
+    glm::vec4 color;
+    glm::vec2 texCoords;
+    GLuint texIndex;
+
+    void setPosition(glm::vec3 const& value) noexcept {
+        position = value;
+    }
+    void setColor(Color const& value) noexcept {
+        color = value;
+    }
+    void setPackedColor(glm::u8vec4 const value) noexcept {
+        color = glm::vec4{ value } / 255.0f;
+    }
+    void setTexCoords(glm::vec2 const& value) noexcept {
+        texCoords = value;
+    }
+    void setTexIndex(GLuint const value) noexcept {
+        texIndex = value;
+    }
+
+    [[nodiscard]] static std::array<VertexAttributeDefinition, 4> layout() noexcept {
+        return {
+            VertexAttributeDefinition{ 3, GL_FLOAT, false },
+            VertexAttributeDefinition{ 4, GL_FLOAT, false },
+            VertexAttributeDefinition{ 2, GL_FLOAT, false },
+            VertexAttributeDefinition{ 1, GL_UNSIGNED_INT, false },
+        };
+    }
+};
+static_assert(alignof(StandardVertex) == 4);
+static_assert(sizeof(StandardVertex[2]) == 2 * sizeof(StandardVertex));
+static_assert(sizeof(StandardVertex) == 10 * sizeof(GLfloat));
+
+struct CompactVertex {
+    glm::vec3 position;
+    glm::u8vec4 color;
+    glm::u16vec2 texCoords;
+    std::uint8_t texIndex;
+    std::array<std::uint8_t, 3> padding;
+
+    void setPosition(glm::vec3 const& value) noexcept {
+        position = value;
+    }
+    void setColor(Color const& value) noexcept {
+        color = detail::packColor(value);
+    }
+    void setPackedColor(glm::u8vec4 const value) noexcept {
+        color = value;
+    }
+    void setTexCoords(glm::vec2 const& value) noexcept {
+        texCoords = detail::packTexCoords(value);
+    }
+    void setTexIndex(GLuint const value) noexcept {
+        texIndex = static_cast<std::uint8_t>(value);
+    }
+
+    [[nodiscard]] static std::array<VertexAttributeDefinition, 4> layout() noexcept {
+        return {
+            VertexAttributeDefinition{ 3, GL_FLOAT, false },
+            VertexAttributeDefinition{ 4, GL_UNSIGNED_BYTE, true },
+            VertexAttributeDefinition{ 2, GL_UNSIGNED_SHORT, true },
+            VertexAttributeDefinition{ 1, GL_UNSIGNED_BYTE, false, 3 },
+        };
+    }
+};
+static_assert(alignof(CompactVertex) == 4);
+static_assert(sizeof(CompactVertex[2]) == 2 * sizeof(CompactVertex));
+static_assert(sizeof(CompactVertex) == 24);
+
+struct CompactHalfPositionVertex {
+    std::array<std::uint16_t, 3> position;
+    std::uint16_t positionPadding;
+    glm::u8vec4 color;
+    glm::u16vec2 texCoords;
+    std::uint8_t texIndex;
+    std::array<std::uint8_t, 3> padding;
+
+    void setPosition(glm::vec3 const& value) noexcept {
+        position = { glm::packHalf1x16(value.x), glm::packHalf1x16(value.y), glm::packHalf1x16(value.z) };
+    }
+    void setColor(Color const& value) noexcept {
+        color = detail::packColor(value);
+    }
+    void setPackedColor(glm::u8vec4 const value) noexcept {
+        color = value;
+    }
+    void setTexCoords(glm::vec2 const& value) noexcept {
+        texCoords = detail::packTexCoords(value);
+    }
+    void setTexIndex(GLuint const value) noexcept {
+        texIndex = static_cast<std::uint8_t>(value);
+    }
+
+    [[nodiscard]] static std::array<VertexAttributeDefinition, 4> layout() noexcept {
+        return {
+            VertexAttributeDefinition{ 3, GL_HALF_FLOAT, false, 2 },
+            VertexAttributeDefinition{ 4, GL_UNSIGNED_BYTE, true },
+            VertexAttributeDefinition{ 2, GL_UNSIGNED_SHORT, true },
+            VertexAttributeDefinition{ 1, GL_UNSIGNED_BYTE, false, 3 },
+        };
+    }
+};
+static_assert(alignof(CompactHalfPositionVertex) == 4);
+static_assert(sizeof(CompactHalfPositionVertex[2]) == 2 * sizeof(CompactHalfPositionVertex));
+static_assert(sizeof(CompactHalfPositionVertex) == 20);
+
+[[nodiscard]] constexpr std::size_t vertexSize(VertexFormat const format) noexcept {
+    switch (format) {
+        case VertexFormat::Compact:
+            return sizeof(CompactVertex);
+        case VertexFormat::CompactHalfPosition:
+            return sizeof(CompactHalfPositionVertex);
+        case VertexFormat::Standard:
+        default:
+            return sizeof(StandardVertex);
+    }
+}
+
+template<typename Vertex>
+void writeQuadVertices(
+        Vertex* const vertices,
+        glm::mat4 const& transformMatrix,
+        Rect const& textureRect,
+        Color const& color,
+        GLuint const texIndex
+) noexcept {
+    constexpr std::array<glm::vec4, 4> positions{
+        glm::vec4{ -1.0f, -1.0f, 0.0f, 1.0f },
+        glm::vec4{  1.0f, -1.0f, 0.0f, 1.0f },
+        glm::vec4{  1.0f,  1.0f, 0.0f, 1.0f },
+        glm::vec4{ -1.0f,  1.0f, 0.0f, 1.0f }
+    };
+    std::array<glm::vec2, 4> const texCoords{
+        glm::vec2{  textureRect.left, textureRect.bottom },
+        glm::vec2{ textureRect.right, textureRect.bottom },
+        glm::vec2{ textureRect.right,    textureRect.top },
+        glm::vec2{  textureRect.left,    textureRect.top }
+    };
+    // color and texture index are the same for all four vertices, so they are only converted once
+    Vertex prototype{};
+    prototype.setColor(color);
+    prototype.setTexIndex(texIndex);
+    for (std::size_t i = 0; i < 4; ++i) {
+        vertices[i] = prototype;
+        vertices[i].setPosition(glm::vec3{ transformMatrix * positions[i] });
+        vertices[i].setTexCoords(texCoords[i]);
+    }
+}
@@ -1,4 +1,5 @@
 #include "window.hpp"
+#include "gl_state_cache.hpp"
 #include "input.hpp"
 #include <exception>
 #include <gsl/gsl>
@@ -9,10 +10,24 @@
 #include <spdlog/spdlog.h>
 
 
-Window::Window(std::string const& title, WindowSize size, OpenGLVersion version, Input& input) noexcept
+Window::Window(
+        std::string const& title,
+        WindowSize size,
+        OpenGLVersion version,
+        Input& input,
+        WindowMode const mode
+) noexcept
     : mFrameBufferSize{ size },
-      mInput{ input } {
-    glfwInit();
+      mInput{ input },
+      mMode{ mode } {
+    if (mode == WindowMode::Headless) {
+        // the null platform doesn't need a display server
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+    if (glfwInit() == GLFW_FALSE) {
+        spdlog::critical("unable to initialize glfw");
+        std::terminate();
+    }
     spdlog::info("glfw initialized");
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -21,9 +36,14 @@ Window::Window(std::string const& title, WindowSize size, OpenGLVersion version,
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version.minor);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    mWindowPtr = glfwCreateWindow(size.width, size.height, title.c_str(), nullptr, nullptr);
+    if (mode == WindowMode::Headless) {
+        mWindowPtr = createHeadlessWindow(title, size);
+    } else {
+        glfwWindowHint(GLFW_SAMPLES, 4);
+        mWindowPtr = glfwCreateWindow(size.width, size.height, title.c_str(), nullptr, nullptr);
+    }
     if (mWindowPtr == nullptr) {
+        spdlog::critical("unable to create the OpenGL context");
         glfwTerminate();
         std::terminate();
         return;
@@ -32,26 +52,33 @@ Window::Window(std::string const& title, WindowSize size, OpenGLVersion version,
     glfwSetWindowUserPointer(mWindowPtr, this);
     glfwSetFramebufferSizeCallback(mWindowPtr, [](GLFWwindow* window, int width, int height) {
         auto& self = *static_cast<Window*>(glfwGetWindowUserPointer(window));
-        self.mFrameBufferSize.width = width;
-        self.mFrameBufferSize.height = height;
-        glViewport(0, 0, width, height);
+        self.mFrameBufferSize = WindowSize{ .width{ width }, .height{ height } };
+        // the context might be current on the render thread
+        if (glfwGetCurrentContext() == window) {
+            GLStateCache::instance().setViewport(0, 0, width, height);
+        }
     });
     glfwSetKeyCallback(mWindowPtr, [](GLFWwindow* window, int keyCode, int, int action, int) {
-        static_cast<Window*>(glfwGetWindowUserPointer(window))->mInput.keyCallback(keyCode, action);
+        static_cast<Window*>(glfwGetWindowUserPointer(window))
+                ->mInput.deviceEvent(InputEvent::key(keyCode, action));
     });
     glfwSetCursorPosCallback(mWindowPtr, [](GLFWwindow* window, double mouseX, double mouseY) {
         auto& self = *static_cast<Window*>(glfwGetWindowUserPointer(window));
-        mouseY = self.mFrameBufferSize.height - mouseY - 1;
-        mouseX -= gsl::narrow_cast<float>(self.mFrameBufferSize.width) / 2.0f;
-        mouseY -= gsl::narrow_cast<float>(self.mFrameBufferSize.height) / 2.0f;
-        self.mInput.mouseCallback(mouseX, mouseY);
+        auto const framebufferSize = self.framebufferSize();
+        mouseY = framebufferSize.height - mouseY - 1;
+        mouseX -= gsl::narrow_cast<float>(framebufferSize.width) / 2.0f;
+        mouseY -= gsl::narrow_cast<float>(framebufferSize.height) / 2.0f;
+        self.mInput.deviceEvent(
+                InputEvent::mouseMove(gsl::narrow_cast<float>(mouseX), gsl::narrow_cast<float>(mouseY))
+        );
     });
     glfwSetCursorEnterCallback(mWindowPtr, [](GLFWwindow* window, int entered) {
         static_cast<Window*>(glfwGetWindowUserPointer(window))
-                ->mInput.mouseEnterOrLeaveCallback(static_cast<bool>(entered));
+                ->mInput.deviceEvent(InputEvent::mouseEnterOrLeave(static_cast<bool>(entered)));
     });
     glfwSetMouseButtonCallback(mWindowPtr, [](GLFWwindow* window, int button, int action, int) {
-        static_cast<Window*>(glfwGetWindowUserPointer(window))->mInput.mouseButtonCallback(button, action);
+        static_cast<Window*>(glfwGetWindowUserPointer(window))
+                ->mInput.deviceEvent(InputEvent::mouseButton(button, action));
     });
     mInput.mouseEnterOrLeaveCallback(static_cast<bool>(glfwGetWindowAttrib(mWindowPtr, GLFW_HOVERED)));
     spdlog::info("glfw window created");
@@ -73,14 +100,27 @@ Window::Window(std::string const& title, WindowSize size, OpenGLVersion version,
         std::terminate();
         return;
     }
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_MULTISAMPLE);
+    GLStateCache::instance().setDepthTestEnabled(true);
+    if (mode == WindowMode::Headless) {
+        auto target = RenderTarget::create(RenderTargetDescription{ .size{ size.width, size.height } });
+        if (!target) {
+            spdlog::critical("unable to create the offscreen framebuffer: {}", target.error());
+            glfwTerminate();
+            std::terminate();
+        }
+        mOffscreenTarget = std::move(target.value());
+    } else {
+        glEnable(GL_MULTISAMPLE);
+    }
+    bindFramebuffer();
     initImGui();
 }
 
 Window::~Window() {
     spdlog::info("exiting application");
     shutdownImGui();
+    // the offscreen target has to be deleted while the context still exists
+    mOffscreenTarget = RenderTarget{};
     glfwDestroyWindow(mWindowPtr);
     glfwTerminate();
 }
@@ -89,6 +129,44 @@ WindowSize Window::framebufferSize() const {
     return mFrameBufferSize;
 }
 
+void Window::bindFramebuffer() const noexcept {
+    if (mMode == WindowMode::Headless) {
+        mOffscreenTarget.bind();
+    } else {
+        RenderTarget::bindDefault(framebufferSize());
+    }
+}
+
+void Window::swapBuffers() const noexcept {
+    if (mMode == WindowMode::Headless) {
+        // there is no surface to present to, but the driver still has to process the commands of the frame
+        glFlush();
+        return;
+    }
+    glfwSwapBuffers(mWindowPtr);
+}
+
+bool Window::shouldClose() const noexcept {
+    return glfwWindowShouldClose(mWindowPtr) == GLFW_TRUE;
+}
+
+GLFWwindow* Window::createHeadlessWindow(std::string const& title, WindowSize const size) noexcept {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    // prefer EGL (EGL_MESA_platform_surfaceless with the null platform) and fall back to OSMesa software rendering
+    for (auto const contextCreationApi : { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API }) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextCreationApi);
+        if (auto const window = glfwCreateWindow(size.width, size.height, title.c_str(), nullptr, nullptr);
+            window != nullptr) {
+            spdlog::info(
+                    "headless context created via {}",
+                    contextCreationApi == GLFW_EGL_CONTEXT_API ? "EGL" : "OSMesa"
+            );
+            return window;
+        }
+    }
+    return nullptr;
+}
+
 void Window::initImGui() noexcept {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
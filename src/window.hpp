@@ -4,15 +4,22 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 // clang-format on
+#include "launch_options.hpp"
 #include "opengl_version.hpp"
+#include "render_target.hpp"
 #include "window_size.hpp"
+#include <atomic>
 #include <string>
 
 class Input;
 
 class Window final {
 public:
-    Window(std::string const& title, WindowSize size, OpenGLVersion version, Input& input) noexcept;
+    Window(std::string const& title,
+           WindowSize size,
+           OpenGLVersion version,
+           Input& input,
+           WindowMode mode = WindowMode::Windowed) noexcept;
     Window(Window const&) = delete;
     Window(Window&&) = delete;
     Window& operator=(Window const&) = delete;
@@ -23,8 +30,16 @@ public:
         return mWindowPtr;
     }
     [[nodiscard]] WindowSize framebufferSize() const;
+    [[nodiscard]] WindowMode mode() const noexcept {
+        return mMode;
+    }
+    // binds the default framebuffer or, in headless mode, the offscreen target that replaces it
+    void bindFramebuffer() const noexcept;
+    void swapBuffers() const noexcept;
+    [[nodiscard]] bool shouldClose() const noexcept;
 
 private:
+    [[nodiscard]] GLFWwindow* createHeadlessWindow(std::string const& title, WindowSize size) noexcept;
     void initImGui() noexcept;
     void shutdownImGui() noexcept;
     static void handleOpenGLDebugOutput(
@@ -39,6 +54,9 @@ private:
 
 private:
     GLFWwindow* mWindowPtr;
-    WindowSize mFrameBufferSize;
+    // written by the event callbacks, but also read by the render thread
+    std::atomic<WindowSize> mFrameBufferSize;
     Input& mInput;
+    WindowMode mMode;
+    RenderTarget mOffscreenTarget;
 };
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// SplitMix64, used to expand a single 64 bit seed into the state of the xoshiro generators
+[[nodiscard]] constexpr std::uint64_t splitMix64(std::uint64_t& state) noexcept {
+    auto z = (state += 0x9E37'79B9'7F4A'7C15ULL);
+    z = (z ^ (z >> 30U)) * 0xBF58'476D'1CE4'E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D0'49BB'1331'11EBULL;
+    return z ^ (z >> 31U);
+}
+
+// xoshiro256** by David Blackman and Sebastiano Vigna (https://prng.di.unimi.it/). 32 bytes of state, passes
+// all statistical tests and supports jumping ahead to create non-overlapping streams (e.g. one per thread).
+class Xoshiro256StarStar final {
+public:
+    using result_type = std::uint64_t;
+
+public:
+    constexpr explicit Xoshiro256StarStar(std::uint64_t const seed = 0x853C'49E6'748F'EA9BULL) noexcept {
+        this->seed(seed);
+    }
+
+    constexpr void seed(std::uint64_t seed) noexcept {
+        for (auto& word : mState) {
+            word = splitMix64(seed);
+        }
+    }
+
+    [[nodiscard]] static constexpr result_type min() noexcept {
+        return std::numeric_limits<result_type>::min();
+    }
+    [[nodiscard]] static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    constexpr result_type operator()() noexcept {
+        auto const result = std::rotl(mState[1] * 5U, 7) * 9U;
+        auto const t = mState[1] << 17U;
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= t;
+        mState[3] = std::rotl(mState[3], 45);
+        return result;
+    }
+
+    // equivalent to 2^128 calls, generates 2^128 non-overlapping subsequences
+    constexpr void jump() noexcept {
+        jump({ 0x180E'C6D3'3CFD'0ABAULL, 0xD5A6'1266'F0C9'392CULL, 0xA958'2618'E03F'C9AAULL, 0x39AB'DC45'29B1'661CULL });
+    }
+
+    // equivalent to 2^192 calls, generates 2^64 starting points for jump()
+    constexpr void longJump() noexcept {
+        jump({ 0x76E1'5D3E'FEFD'CBBFULL, 0xC500'4E44'1C52'2FB3ULL, 0x7771'0069'854E'E241ULL, 0x3910'9BB0'2ACB'E635ULL });
+    }
+
+    // returns a generator for the current stream and continues with the next non-overlapping stream itself
+    [[nodiscard]] constexpr Xoshiro256StarStar split() noexcept {
+        auto result = *this;
+        jump();
+        return result;
+    }
+
+    [[nodiscard]] constexpr bool operator==(Xoshiro256StarStar const&) const noexcept = default;
+
+private:
+    constexpr void jump(std::array<std::uint64_t, 4> const& polynomial) noexcept {
+        auto jumped = std::array<std::uint64_t, 4>{};
+        for (auto const word : polynomial) {
+            for (unsigned bit = 0; bit < 64U; ++bit) {
+                if ((word & (std::uint64_t{ 1 } << bit)) != 0U) {
+                    for (std::size_t i = 0; i < jumped.size(); ++i) {
+                        jumped[i] ^= mState[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        mState = jumped;
+    }
+
+private:
+    std::array<std::uint64_t, 4> mState{};
+
+    friend class Xoshiro256StarStarX4;
+};
+
+// Four independent xoshiro256** streams stored as structure of arrays, so that generating four numbers at
+// once compiles to SIMD instructions. Used for bulk generation.
+class Xoshiro256StarStarX4 final {
+public:
+    static constexpr std::size_t numLanes = 4;
+
+public:
+    // Every lane starts at the current state of the given generator, which is long jumped after each lane. The
+    // lanes are 2^192 steps apart, so the jump() streams of the source never overlap with them.
+    constexpr explicit Xoshiro256StarStarX4(Xoshiro256StarStar& source) noexcept {
+        for (std::size_t lane = 0; lane < numLanes; ++lane) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                mState[i][lane] = source.mState[i];
+            }
+            source.longJump();
+        }
+    }
+
+    constexpr void operator()(std::array<std::uint64_t, numLanes>& results) noexcept {
+        auto& [s0, s1, s2, s3] = mState;
+        for (std::size_t lane = 0; lane < numLanes; ++lane) {
+            results[lane] = std::rotl(s1[lane] * 5U, 7) * 9U;
+            auto const t = s1[lane] << 17U;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = std::rotl(s3[lane], 45);
+        }
+    }
+
+private:
+    alignas(32) std::array<std::array<std::uint64_t, numLanes>, 4> mState{};
+};
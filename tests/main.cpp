@@ -0,0 +1,13 @@
+#include "tests.hpp"
+#include <cstdlib>
+
+int main() {
+    auto context = tests::Context{};
+    tests::runRandomTests(context);
+    if (context.numFailures() > 0) {
+        spdlog::error("{} of {} checks failed", context.numFailures(), context.numChecks());
+        return EXIT_FAILURE;
+    }
+    spdlog::info("all {} checks passed", context.numChecks());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#include "random.hpp"
+#include "tests.hpp"
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace tests {
+    namespace {
+        constexpr std::size_t numValues = 4'096;
+
+        // scalar and bulk output of a generator
+        [[nodiscard]] std::vector<std::uint64_t> output(Random& random) {
+            auto result = std::vector<std::uint64_t>(numValues);
+            for (auto& value : result) {
+                value = random.get<std::uint64_t>();
+            }
+            auto bulk = std::vector<std::uint64_t>(numValues);
+            random.fill(bulk);
+            result.insert(result.end(), bulk.begin(), bulk.end());
+            return result;
+        }
+
+        void testNestedSplits(Context& context) {
+            auto root = Random{ 42 };
+            auto child = root.split();
+            auto grandchild = child.split();
+            auto secondChild = root.split();
+            auto secondGrandchild = child.split();
+            auto generators = std::array{ &root, &child, &grandchild, &secondChild, &secondGrandchild };
+
+            // 64 bit values of non-overlapping streams collide with negligible probability
+            auto values = std::unordered_set<std::uint64_t>{};
+            for (auto const generator : generators) {
+                for (auto const value : output(*generator)) {
+                    values.insert(value);
+                }
+            }
+            context.check(values.size() == generators.size() * 2 * numValues, "split generators share values");
+        }
+
+        void testSplitsAreDeterministic(Context& context) {
+            auto first = Random{ 7 };
+            auto second = Random{ 7 };
+            auto firstGrandchild = first.split().split();
+            auto secondGrandchild = second.split().split();
+            context.check(output(firstGrandchild) == output(secondGrandchild), "splits are not deterministic");
+            context.check(output(first) == output(second), "splitting changes the parent differently");
+        }
+
+        void testIntegerRanges(Context& context) {
+            auto random = Random{ 1 };
+            auto isInRange = true;
+            for (std::size_t i = 0; i < numValues; ++i) {
+                // spans that don't fit into the signed type
+                static_cast<void>(random.range(INT_MIN, INT_MAX));
+                static_cast<void>(random.range(std::int64_t{ LLONG_MIN }, std::int64_t{ LLONG_MAX }));
+                static_cast<void>(random.range(std::int8_t{ -128 }, std::int8_t{ 127 }));
+                auto const value = random.range(-5, 5);
+                auto const unsignedValue = random.range(std::uint8_t{ 3 }, std::uint8_t{ 200 });
+                isInRange = isInRange && value >= -5 && value <= 5 && unsignedValue >= 3 && unsignedValue <= 200;
+            }
+            context.check(isInRange, "range() returned a value outside of the range");
+        }
+    } // namespace
+
+    void runRandomTests(Context& context) {
+        testNestedSplits(context);
+        testSplitsAreDeterministic(context);
+        testIntegerRanges(context);
+    }
+} // namespace tests
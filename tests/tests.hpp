@@ -0,0 +1,36 @@
+#pragma once
+
+#include <source_location>
+#include <spdlog/spdlog.h>
+#include <string_view>
+
+namespace tests {
+    // Minimal checking without a test framework: failed checks are logged and make the executable return an error.
+    class Context final {
+    public:
+        void check(
+                bool const condition,
+                std::string_view const description,
+                std::source_location const location = std::source_location::current()
+        ) noexcept {
+            ++mNumChecks;
+            if (!condition) {
+                ++mNumFailures;
+                spdlog::error("{}:{}: check failed: {}", location.file_name(), location.line(), description);
+            }
+        }
+
+        [[nodiscard]] std::size_t numChecks() const noexcept {
+            return mNumChecks;
+        }
+        [[nodiscard]] std::size_t numFailures() const noexcept {
+            return mNumFailures;
+        }
+
+    private:
+        std::size_t mNumChecks{ 0 };
+        std::size_t mNumFailures{ 0 };
+    };
+
+    void runRandomTests(Context& context);
+} // namespace tests